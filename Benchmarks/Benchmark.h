@@ -0,0 +1,43 @@
+/* Benchmark helpers:
+ * Timing loop shared by the benchmarks
+ * Scalar conversion for the float and fixed point instantiations
+ * */
+
+#ifndef MATH_BENCHMARK_H
+#define MATH_BENCHMARK_H
+
+#include <chrono>
+#include "../FixedPoint.h"
+
+namespace Benchmark {
+    // Runs Function until at least 0.2 s went by, returns microseconds per call
+    template<class Function>
+    double Time(Function&& Run) {
+        typedef std::chrono::steady_clock Clock;
+        Run(); // warm up
+
+        long long calls = 0;
+        Clock::time_point start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            Run();
+            ++calls;
+            elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        } while (elapsed < 200000.0);
+        return elapsed / double(calls);
+    }
+
+    // Value as T, for loading the same inputs into every scalar type
+    template<class T> T Scalar(float Value);
+    template<> inline float Scalar<float>(float Value) { return Value; }
+    template<> inline Math::Fixed16_16 Scalar<Math::Fixed16_16>(float Value) {
+        return Math::Fixed16_16::FromDouble(Value);
+    }
+#if defined(__SIZEOF_INT128__)
+    template<> inline Math::Fixed32_32 Scalar<Math::Fixed32_32>(float Value) {
+        return Math::Fixed32_32::FromDouble(Value);
+    }
+#endif
+}
+
+#endif //MATH_BENCHMARK_H
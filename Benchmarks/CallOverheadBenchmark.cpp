@@ -0,0 +1,109 @@
+/* Call overhead benchmark:
+ * Out of line calls through the PLT (before) against the constexpr
+ * functions of MATH.h inlined into the caller (after)
+ * Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers
+ * */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../MATH.h"
+#include "OutOfLineMath.h"
+#include "Benchmark.h"
+
+using namespace Geometry_2D;
+using Benchmark::Time;
+
+static float Random(float Min, float Max) {
+    return Min + (Max - Min) * float(std::rand()) / float(RAND_MAX);
+}
+
+const int Count = 4096;
+
+static void Print(const char* Name, double Before, double After) {
+    std::printf("  %-38s %10.2f %10.2f %8.1fx\n", Name, 1000.0 * Before / Count, 1000.0 * After / Count,
+                Before / After);
+}
+
+int main() {
+    std::srand(1);
+    std::vector<SVector_2D> points1(Count), points2(Count), sums(Count);
+    std::vector<float> values(Count), fractions(Count), results(Count);
+    for (int i = 0; i < Count; ++i) {
+        points1[i] = SVector_2D(Random(-100.0f, 100.0f), Random(-100.0f, 100.0f));
+        points2[i] = SVector_2D(Random(-100.0f, 100.0f), Random(-100.0f, 100.0f));
+        values[i] = Random(-360.0f, 360.0f);
+        fractions[i] = Random(0.0f, 1.0f);
+    }
+
+    double sink = 0.0;
+
+    double dotBefore = Time([&]() {
+        float sum = 0.0f;
+        for (int i = 0; i < Count; ++i) sum += OutOfLine::DotProduct(points1[i], points2[i]);
+        sink += sum;
+    });
+    double dotAfter = Time([&]() {
+        float sum = 0.0f;
+        for (int i = 0; i < Count; ++i) sum += DotProduct(points1[i], points2[i]);
+        sink += sum;
+    });
+
+    double addBefore = Time([&]() {
+        for (int i = 0; i < Count; ++i) sums[i] = OutOfLine::Add(points1[i], points2[i]);
+        sink += sums[0].X;
+    });
+    double addAfter = Time([&]() {
+        for (int i = 0; i < Count; ++i) sums[i] = points1[i] + points2[i];
+        sink += sums[0].X;
+    });
+
+    double rectangleBefore = Time([&]() {
+        int overlaps = 0;
+        CRectangle previous = OutOfLine::CreateRectangleIncludingTwoPoints(points1[0], points2[0]);
+        for (int i = 1; i < Count; ++i) {
+            CRectangle rect = OutOfLine::CreateRectangleIncludingTwoPoints(points1[i], points2[i]);
+            overlaps += OutOfLine::DoRectanglesOverlap(rect, previous);
+            previous = rect;
+        }
+        sink += overlaps;
+    });
+    double rectangleAfter = Time([&]() {
+        int overlaps = 0;
+        CRectangle previous = CreateRectangleIncludingTwoPoints(points1[0], points2[0]);
+        for (int i = 1; i < Count; ++i) {
+            CRectangle rect = CreateRectangleIncludingTwoPoints(points1[i], points2[i]);
+            overlaps += DoRectanglesOverlap(rect, previous);
+            previous = rect;
+        }
+        sink += overlaps;
+    });
+
+    double radiansBefore = Time([&]() {
+        for (int i = 0; i < Count; ++i) results[i] = OutOfLine::DegreesToRadians(values[i]);
+        sink += results[0];
+    });
+    double radiansAfter = Time([&]() {
+        for (int i = 0; i < Count; ++i) results[i] = Math::DegreesToRadians(values[i]);
+        sink += results[0];
+    });
+
+    double lerpBefore = Time([&]() {
+        for (int i = 0; i < Count; ++i) results[i] = OutOfLine::Lerp(values[i], 1.0f, fractions[i]);
+        sink += results[0];
+    });
+    double lerpAfter = Time([&]() {
+        for (int i = 0; i < Count; ++i) results[i] = Math::Lerp(values[i], 1.0f, fractions[i]);
+        sink += results[0];
+    });
+
+    std::printf("Call overhead: %d calls per loop\n", Count);
+    std::printf("  %-38s %10s %10s %9s\n", "ns/call", "PLT", "inline", "speedup");
+    Print("DotProduct", dotBefore, dotAfter);
+    Print("SVector_2D operator+", addBefore, addAfter);
+    Print("CreateRectangle + DoRectanglesOverlap", rectangleBefore, rectangleAfter);
+    Print("DegreesToRadians", radiansBefore, radiansAfter);
+    Print("Lerp", lerpBefore, lerpAfter);
+    if (sink == 0.123) std::printf("\n"); // keeps the results alive
+    return 0;
+}
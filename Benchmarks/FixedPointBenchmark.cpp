@@ -0,0 +1,136 @@
+/* Fixed point benchmark:
+ * Float against Q16.16 and Q32.32 geometry
+ * Separating axis test, streaming Minkowski difference
+ * Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers
+ * */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../FixedGeometry.h"
+#include "../GJK.h"
+#include "Benchmark.h"
+
+using namespace Geometry_2D;
+using Math::Fixed16_16;
+using Math::Fixed32_32;
+using Benchmark::Time;
+using Benchmark::Scalar;
+
+template<class T>
+static std::vector<TVector_2D<T> > Convert(const std::vector<SVector_2D>& Points) {
+    std::vector<TVector_2D<T> > result;
+    for (size_t i = 0; i < Points.size(); ++i) {
+        result.push_back(TVector_2D<T>(Scalar<T>(Points[i].X), Scalar<T>(Points[i].Y)));
+    }
+    return result;
+}
+
+static float Random(float Min, float Max) {
+    return Min + (Max - Min) * float(std::rand()) / float(RAND_MAX);
+}
+
+const int PolygonCount = 256;
+const int PairCount = 4096;
+
+// Regular polygons with 3 to 8 sides, coordinates within +-30
+static std::vector<std::vector<SVector_2D> > RandomPolygons() {
+    std::vector<std::vector<SVector_2D> > polygons(PolygonCount);
+    for (int i = 0; i < PolygonCount; ++i) {
+        int sides = 3 + std::rand() % 6;
+        float radius = Random(2.0f, 10.0f);
+        float rotation = Random(0.0f, 6.28f);
+        SVector_2D center(Random(-20.0f, 20.0f), Random(-20.0f, 20.0f));
+        for (int v = 0; v < sides; ++v) {
+            float angle = rotation + 6.2831853f * v / sides;
+            polygons[i].push_back(SVector_2D(center.X + radius * std::cos(angle), center.Y + radius * std::sin(angle)));
+        }
+    }
+    return polygons;
+}
+
+template<class T>
+static double TimeSeparatingAxis(const std::vector<std::vector<SVector_2D> >& Polygons, int& Overlaps) {
+    std::vector<std::vector<TVector_2D<T> > > polygons;
+    for (size_t i = 0; i < Polygons.size(); ++i) polygons.push_back(Convert<T>(Polygons[i]));
+
+    return Time([&]() {
+        Overlaps = 0;
+        for (int p = 0; p < PairCount; ++p) {
+            const std::vector<TVector_2D<T> >& a = polygons[p % PolygonCount];
+            const std::vector<TVector_2D<T> >& b = polygons[(p * 7 + 3) % PolygonCount];
+            Overlaps += DoConvexPolygonsOverlap(a.data(), a.size(), b.data(), b.size());
+        }
+    });
+}
+
+template<class T>
+static double TimeMinkowski(const std::vector<SVector_2D>& Set1, const std::vector<SVector_2D>& Set2, double& Sink) {
+    std::vector<TVector_2D<T> > set1 = Convert<T>(Set1);
+    std::vector<TVector_2D<T> > set2 = Convert<T>(Set2);
+
+    return Time([&]() {
+        Collision::MinkowskiDiff(set1.begin(), set1.end(), set2.begin(), set2.end(),
+                                 [&](const TVector_2D<T>* Points, size_t Count) {
+                                     T sum = T();
+                                     for (size_t i = 0; i < Count; ++i) sum += Points[i].X;
+                                     Sink += double(Count) + (sum > T() ? 1.0 : 0.0);
+                                 });
+    });
+}
+
+int main() {
+    std::srand(1);
+    std::vector<std::vector<SVector_2D> > polygons = RandomPolygons();
+
+    // canonical float stack: cached unit normals and a bounds reject first
+    std::vector<CPolygon> canonical;
+    for (int i = 0; i < PolygonCount; ++i) canonical.push_back(CPolygon(polygons[i]));
+    int canonicalOverlaps = 0;
+    double canonicalSat = Time([&]() {
+        canonicalOverlaps = 0;
+        for (int p = 0; p < PairCount; ++p) {
+            canonicalOverlaps += DoPolygonsOverlap(canonical[p % PolygonCount], canonical[(p * 7 + 3) % PolygonCount]);
+        }
+    });
+
+    int floatOverlaps = 0, q16Overlaps = 0, q32Overlaps = 0;
+    double floatSat = TimeSeparatingAxis<float>(polygons, floatOverlaps);
+    double q16Sat = TimeSeparatingAxis<Fixed16_16>(polygons, q16Overlaps);
+    double q32Sat = TimeSeparatingAxis<Fixed32_32>(polygons, q32Overlaps);
+
+    std::vector<SVector_2D> set1, set2;
+    for (int i = 0; i < 512; ++i) set1.push_back(SVector_2D(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f)));
+    for (int i = 0; i < 512; ++i) set2.push_back(SVector_2D(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f)));
+
+    double sink = 0.0;
+    double canonicalMinkowski = Time([&]() {
+        Collision::MinkowskiDiff(set1.begin(), set1.end(), set2.begin(), set2.end(),
+                                 [&](const SVector_2D* Points, size_t Count) {
+                                     float sum = 0.0f;
+                                     for (size_t i = 0; i < Count; ++i) sum += Points[i].X;
+                                     sink += double(Count) + (sum > 0.0f ? 1.0 : 0.0);
+                                 });
+    });
+    double floatMinkowski = TimeMinkowski<float>(set1, set2, sink);
+    double q16Minkowski = TimeMinkowski<Fixed16_16>(set1, set2, sink);
+    double q32Minkowski = TimeMinkowski<Fixed32_32>(set1, set2, sink);
+
+    std::printf("Separating axis: %d pairs of convex polygons with 3 to 8 sides\n", PairCount);
+    std::printf("  %-24s %12s %10s\n", "", "ns/pair", "overlaps");
+    std::printf("  %-24s %12.1f %10d\n", "CPolygon (float)", 1000.0 * canonicalSat / PairCount, canonicalOverlaps);
+    std::printf("  %-24s %12.1f %10d\n", "TVector_2D<float>", 1000.0 * floatSat / PairCount, floatOverlaps);
+    std::printf("  %-24s %12.1f %10d\n", "TVector_2D<Fixed16_16>", 1000.0 * q16Sat / PairCount, q16Overlaps);
+    std::printf("  %-24s %12.1f %10d\n", "TVector_2D<Fixed32_32>", 1000.0 * q32Sat / PairCount, q32Overlaps);
+
+    double points = double(set1.size()) * double(set2.size());
+    std::printf("Streaming Minkowski difference: %d x %d points\n", int(set1.size()), int(set2.size()));
+    std::printf("  %-24s %12s\n", "", "ns/point");
+    std::printf("  %-24s %12.2f\n", "SVector_2D", 1000.0 * canonicalMinkowski / points);
+    std::printf("  %-24s %12.2f\n", "TVector_2D<float>", 1000.0 * floatMinkowski / points);
+    std::printf("  %-24s %12.2f\n", "TVector_2D<Fixed16_16>", 1000.0 * q16Minkowski / points);
+    std::printf("  %-24s %12.2f\n", "TVector_2D<Fixed32_32>", 1000.0 * q32Minkowski / points);
+    if (sink == 0.123) std::printf("\n"); // keeps the results alive
+    return 0;
+}
@@ -0,0 +1,46 @@
+/* Out of line math:
+ * Copies of the MATH.h functions as they were before they became constexpr,
+ * built into their own shared library so every call goes through the PLT
+ * */
+
+#include "OutOfLineMath.h"
+
+namespace OutOfLine {
+    SVector_2D Add(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return SVector_2D(Vector1.X + Vector2.X, Vector1.Y + Vector2.Y);
+    }
+
+    float DotProduct(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return Vector1.X*Vector2.X + Vector1.Y*Vector2.Y;
+    }
+
+    CRectangle CreateRectangleIncludingTwoPoints(const SVector_2D& Point1, const SVector_2D& Point2) {
+        SVector_2D TL;
+        TL.X = Point1.X < Point2.X ? Point1.X : Point2.X;
+        TL.Y = Point1.Y < Point2.Y ? Point1.Y: Point2.Y;
+
+        SVector_2D BR;
+        BR.X = Point1.X < Point2.X ? Point2.X : Point1.X;
+        BR.Y = Point1.Y < Point2.Y ? Point2.Y: Point1.Y;
+
+        return CRectangle(TL, BR);
+    }
+
+    bool DoRectanglesOverlap(const CRectangle& R1, const CRectangle& R2) {
+        if ((R1.TopLeft.X < R2.BottomRight.X) && (R1.BottomRight.X > R2.TopLeft.X) &&
+            (R1.TopLeft.Y < R2.BottomRight.Y) && (R1.BottomRight.Y > R2.TopLeft.Y)) return true;
+
+        return false;
+    }
+
+    // with the corrected formula, so both sides compute the same values
+    float DegreesToRadians(float Deg) {
+        return Deg * (Math::PI / 180);
+    }
+
+    float Lerp(float a, float b, float f) {
+        if (f < 0.0f || f > 1.0f) return 0.0f;
+
+        return (1 - f) * a + f * b;
+    }
+}
@@ -0,0 +1,25 @@
+/* Out of line math:
+ * Copies of the MATH.h functions as they were before they became constexpr,
+ * built into their own shared library so every call goes through the PLT
+ * */
+
+#ifndef MATH_OUTOFLINEMATH_H
+#define MATH_OUTOFLINEMATH_H
+
+#include "../MATH.h"
+
+using Geometry_2D::SVector_2D;
+using Geometry_2D::CRectangle;
+
+namespace OutOfLine {
+    SVector_2D Add(const SVector_2D& Vector1, const SVector_2D& Vector2);
+    float DotProduct(const SVector_2D& Vector1, const SVector_2D& Vector2);
+
+    CRectangle CreateRectangleIncludingTwoPoints(const SVector_2D& Point1, const SVector_2D& Point2);
+    bool DoRectanglesOverlap(const CRectangle& R1, const CRectangle& R2);
+
+    float DegreesToRadians(float Deg);
+    float Lerp(float a, float b, float f);
+}
+
+#endif //MATH_OUTOFLINEMATH_H
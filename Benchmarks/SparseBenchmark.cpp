@@ -0,0 +1,103 @@
+/* Sparse benchmark:
+ * CSR/CSC against a dense Matrix on banded and grid Laplacian patterns
+ * SpMV, transpose, addition
+ * Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers
+ * */
+
+#include <cstdio>
+#include <vector>
+#include "../Sparse.h"
+#include "Benchmark.h"
+
+using namespace Math;
+using Benchmark::Time;
+
+// Half bandwidth 4: 9 entries per row, like a 1D high order stencil
+static CooMatrix<double> Banded(int N) {
+    CooMatrix<double> coo(N, N);
+    for (int i = 0; i < N; ++i) {
+        for (int j = i - 4; j <= i + 4; ++j) {
+            coo.Add(i, j, i == j ? 8.0 : -1.0);
+        }
+    }
+    return coo;
+}
+
+// Graph Laplacian of a Side x Side grid, 5 entries per row
+static CooMatrix<double> GridLaplacian(int Side) {
+    int n = Side * Side;
+    CooMatrix<double> coo(n, n);
+    for (int y = 0; y < Side; ++y) {
+        for (int x = 0; x < Side; ++x) {
+            int i = y * Side + x;
+            int degree = 0;
+            const int dx[] = {1, -1, 0, 0};
+            const int dy[] = {0, 0, 1, -1};
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + dx[d], ny = y + dy[d];
+                if (nx < 0 || nx >= Side || ny < 0 || ny >= Side) continue;
+                coo.Add(i, ny * Side + nx, -1.0);
+                ++degree;
+            }
+            coo.Add(i, i, double(degree));
+        }
+    }
+    return coo;
+}
+
+static void Run(const char* Name, const CooMatrix<double>& Coo) {
+    int n = Coo.Rows();
+    CsrMatrix<double> csr(Coo);
+    CscMatrix<double> csc(Coo);
+    Matrix<double> dense = csr.ToDense();
+    Matrix<double> denseOut(n, n);
+
+    std::vector<double> x(n, 1.0), y(n);
+    double sink = 0.0;
+
+    // Matrix<T> has no double mat-vec or sum of its own, the dense side
+    // is plain loops over its rows
+    double denseSpmv = Time([&]() {
+        for (int i = 0; i < n; ++i) {
+            const double* row = dense[i];
+            double sum = 0.0;
+            for (int j = 0; j < n; ++j) sum += row[j] * x[j];
+            y[i] = sum;
+        }
+        sink += y[0];
+    });
+    double csrSpmv = Time([&]() { csr.Multiply(x.data(), y.data()); sink += y[0]; });
+    double cscSpmv = Time([&]() { csc.Multiply(x.data(), y.data()); sink += y[0]; });
+
+    double denseTranspose = Time([&]() {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) denseOut[j][i] = dense[i][j];
+        }
+        sink += denseOut[0][0];
+    });
+    double csrTranspose = Time([&]() { sink += csr.GetTranspose().NonZeros(); });
+    double cscTranspose = Time([&]() { sink += csc.GetTranspose().NonZeros(); });
+
+    double denseAdd = Time([&]() {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) denseOut[i][j] = dense[i][j] + dense[i][j];
+        }
+        sink += denseOut[0][0];
+    });
+    double csrAdd = Time([&]() { sink += (csr + csr).NonZeros(); });
+    double cscAdd = Time([&]() { sink += (csc + csc).NonZeros(); });
+
+    std::printf("%s: %d x %d, %d non zeros (%.3f%%)\n", Name, n, n, csr.NonZeros(),
+                100.0 * csr.NonZeros() / (double(n) * n));
+    std::printf("  %-10s %12s %12s %12s\n", "us/call", "dense", "CSR", "CSC");
+    std::printf("  %-10s %12.1f %12.1f %12.1f\n", "SpMV", denseSpmv, csrSpmv, cscSpmv);
+    std::printf("  %-10s %12.1f %12.1f %12.1f\n", "transpose", denseTranspose, csrTranspose, cscTranspose);
+    std::printf("  %-10s %12.1f %12.1f %12.1f\n", "addition", denseAdd, csrAdd, cscAdd);
+    if (sink == 0.123) std::printf("\n"); // keeps the results alive
+}
+
+int main() {
+    Run("Banded", Banded(2000));
+    Run("Grid Laplacian", GridLaplacian(45));
+    return 0;
+}
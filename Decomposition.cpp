@@ -0,0 +1,467 @@
+/* Decompositions:
+ * LU with partial pivoting
+ * Cholesky
+ * Householder QR
+ * Batched 2x2, 3x3 and 4x4 solvers
+ * */
+
+#include "Decomposition.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Math {
+    template<class T>
+    static void SwapRows(Matrix<T>& A, int Row1, int Row2, int Cols) {
+        if (Row1 == Row2) return;
+        std::swap_ranges(A[Row1], A[Row1] + Cols, A[Row2]);
+    }
+
+
+
+    // ===== LU =====
+    template<class T>
+    bool LUDecompose(Matrix<T>& A, std::vector<int>& Pivots, int* Sign) {
+        int n = A.Rows();
+        if (n != A.Cols()) return false;
+
+        Pivots.resize(n);
+        int sign = 1;
+
+        for (int k0 = 0; k0 < n; k0 += LUBlockSize) {
+            int k1 = std::min(k0 + LUBlockSize, n);
+
+            // Panel: unblocked elimination restricted to columns [k0, k1)
+            for (int k = k0; k < k1; ++k) {
+                int pivot = k;
+                T pivotValue = std::abs(A[k][k]);
+                for (int i = k + 1; i < n; ++i) {
+                    T value = std::abs(A[i][k]);
+                    if (value > pivotValue) {
+                        pivot = i;
+                        pivotValue = value;
+                    }
+                }
+                if (pivotValue == T(0)) return false;
+
+                Pivots[k] = pivot;
+                if (pivot != k) {
+                    SwapRows(A, k, pivot, n);
+                    sign = -sign;
+                }
+
+                const T* rowK = A[k];
+                T inverse = T(1) / rowK[k];
+                for (int i = k + 1; i < n; ++i) {
+                    T* rowI = A[i];
+                    T l = rowI[k] * inverse;
+                    rowI[k] = l;
+                    for (int j = k + 1; j < k1; ++j) {
+                        rowI[j] -= l * rowK[j];
+                    }
+                }
+            }
+
+            if (k1 == n) break;
+
+            // U12 = L11^-1 A12
+            for (int k = k0; k < k1; ++k) {
+                const T* rowK = A[k];
+                for (int i = k + 1; i < k1; ++i) {
+                    T* rowI = A[i];
+                    T l = rowI[k];
+                    for (int j = k1; j < n; ++j) {
+                        rowI[j] -= l * rowK[j];
+                    }
+                }
+            }
+
+            // A22 -= L21 U12, the panel rows stay hot in cache for every row of A22
+            for (int i = k1; i < n; ++i) {
+                T* rowI = A[i];
+                for (int k = k0; k < k1; ++k) {
+                    T l = rowI[k];
+                    const T* rowK = A[k];
+                    for (int j = k1; j < n; ++j) {
+                        rowI[j] -= l * rowK[j];
+                    }
+                }
+            }
+        }
+
+        if (Sign != nullptr) *Sign = sign;
+        return true;
+    }
+
+    template<class T>
+    void LUSolve(const Matrix<T>& LU, const std::vector<int>& Pivots, T* b) {
+        int n = LU.Rows();
+
+        for (int k = 0; k < n; ++k) {
+            std::swap(b[k], b[Pivots[k]]);
+        }
+
+        // L y = Pb
+        for (int i = 0; i < n; ++i) {
+            const T* row = LU[i];
+            T sum = b[i];
+            for (int j = 0; j < i; ++j) {
+                sum -= row[j] * b[j];
+            }
+            b[i] = sum;
+        }
+
+        // U x = y
+        for (int i = n - 1; i >= 0; --i) {
+            const T* row = LU[i];
+            T sum = b[i];
+            for (int j = i + 1; j < n; ++j) {
+                sum -= row[j] * b[j];
+            }
+            b[i] = sum / row[i];
+        }
+    }
+    // ===== LU =====
+
+
+
+    // ===== CHOLESKY =====
+    template<class T>
+    bool CholeskyDecompose(Matrix<T>& A) {
+        int n = A.Rows();
+        if (n != A.Cols()) return false;
+
+        // Row by row (Cholesky-Crout), every dot product runs over two contiguous rows
+        for (int i = 0; i < n; ++i) {
+            T* rowI = A[i];
+            for (int j = 0; j <= i; ++j) {
+                const T* rowJ = A[j];
+                T sum = rowI[j];
+                for (int k = 0; k < j; ++k) {
+                    sum -= rowI[k] * rowJ[k];
+                }
+
+                if (i == j) {
+                    if (!(sum > T(0))) return false;
+                    rowI[i] = std::sqrt(sum);
+                } else {
+                    rowI[j] = sum / rowJ[j];
+                }
+            }
+            for (int j = i + 1; j < n; ++j) {
+                rowI[j] = T(0);
+            }
+        }
+
+        return true;
+    }
+
+    template<class T>
+    void CholeskySolve(const Matrix<T>& L, T* b) {
+        int n = L.Rows();
+
+        // L y = b
+        for (int i = 0; i < n; ++i) {
+            const T* row = L[i];
+            T sum = b[i];
+            for (int j = 0; j < i; ++j) {
+                sum -= row[j] * b[j];
+            }
+            b[i] = sum / row[i];
+        }
+
+        // L^T x = y, walking the rows of L keeps the access contiguous
+        for (int i = n - 1; i >= 0; --i) {
+            const T* row = L[i];
+            b[i] /= row[i];
+            T value = b[i];
+            for (int j = 0; j < i; ++j) {
+                b[j] -= row[j] * value;
+            }
+        }
+    }
+    // ===== CHOLESKY =====
+
+
+
+    // ===== QR =====
+    template<class T>
+    bool QRDecompose(Matrix<T>& A, std::vector<T>& Tau) {
+        int n = A.Rows();
+        int m = A.Cols();
+        if (n < m) return false;
+
+        Tau.assign(m, T(0));
+        std::vector<T> w(m);
+
+        for (int k = 0; k < m; ++k) {
+            T norm = T(0);
+            for (int i = k; i < n; ++i) {
+                norm += A[i][k] * A[i][k];
+            }
+            norm = std::sqrt(norm);
+            if (norm == T(0)) continue; // H(k) = I
+
+            T x0 = A[k][k];
+            T beta = x0 > T(0) ? -norm : norm;
+            T scale = T(1) / (x0 - beta);
+            Tau[k] = (beta - x0) / beta;
+            A[k][k] = beta;
+            for (int i = k + 1; i < n; ++i) {
+                A[i][k] *= scale;
+            }
+
+            // Apply H(k) to the remaining columns: w = v^T A, A -= Tau v w,
+            // accumulated row by row to stay cache friendly
+            for (int j = k + 1; j < m; ++j) {
+                w[j] = A[k][j];
+            }
+            for (int i = k + 1; i < n; ++i) {
+                const T* row = A[i];
+                T v = row[k];
+                for (int j = k + 1; j < m; ++j) {
+                    w[j] += v * row[j];
+                }
+            }
+            for (int j = k + 1; j < m; ++j) {
+                A[k][j] -= Tau[k] * w[j];
+            }
+            for (int i = k + 1; i < n; ++i) {
+                T* row = A[i];
+                T v = Tau[k] * row[k];
+                for (int j = k + 1; j < m; ++j) {
+                    row[j] -= v * w[j];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    template<class T>
+    bool QRSolve(const Matrix<T>& QR, const std::vector<T>& Tau, T* b) {
+        int n = QR.Rows();
+        int m = QR.Cols();
+
+        // b = Q^T b
+        for (int k = 0; k < m; ++k) {
+            T w = b[k];
+            for (int i = k + 1; i < n; ++i) {
+                w += QR[i][k] * b[i];
+            }
+            w *= Tau[k];
+            b[k] -= w;
+            for (int i = k + 1; i < n; ++i) {
+                b[i] -= w * QR[i][k];
+            }
+        }
+
+        // R x = b
+        for (int i = m - 1; i >= 0; --i) {
+            const T* row = QR[i];
+            if (row[i] == T(0)) return false;
+
+            T sum = b[i];
+            for (int j = i + 1; j < m; ++j) {
+                sum -= row[j] * b[j];
+            }
+            b[i] = sum / row[i];
+        }
+
+        return true;
+    }
+    // ===== QR =====
+
+
+
+    template<class T>
+    T Determinant(const Matrix<T>& A) {
+        Matrix<T> LU(A);
+        std::vector<int> pivots;
+        int sign = 1;
+        if (!LUDecompose(LU, pivots, &sign)) return T(0);
+
+        T determinant = T(sign);
+        for (int i = 0, n = LU.Rows(); i < n; ++i) {
+            determinant *= LU[i][i];
+        }
+        return determinant;
+    }
+
+    template<class T>
+    Matrix<T> Inverse(const Matrix<T>& A) {
+        Matrix<T> LU(A);
+        std::vector<int> pivots;
+        if (!LUDecompose(LU, pivots)) return Matrix<T>();
+
+        int n = LU.Rows();
+        Matrix<T> Result(n, n);
+        std::vector<T> column(n);
+        for (int j = 0; j < n; ++j) {
+            std::fill(column.begin(), column.end(), T(0));
+            column[j] = T(1);
+            LUSolve(LU, pivots, column.data());
+            for (int i = 0; i < n; ++i) {
+                Result[i][j] = column[i];
+            }
+        }
+        return Result;
+    }
+
+
+
+    // ===== BATCHED =====
+    template<class T>
+    int SolveBatched2x2(int Count, const T* A, const T* b, T* x) {
+        const T* a00 = A;
+        const T* a01 = A + Count;
+        const T* a10 = A + 2 * Count;
+        const T* a11 = A + 3 * Count;
+        const T* b0 = b;
+        const T* b1 = b + Count;
+        int singular = 0;
+
+        #pragma omp simd reduction(+:singular)
+        for (int s = 0; s < Count; ++s) {
+            T det = a00[s] * a11[s] - a01[s] * a10[s];
+            singular += det == T(0) ? 1 : 0;
+            T inverse = det != T(0) ? T(1) / det : T(0);
+
+            x[s] = (b0[s] * a11[s] - a01[s] * b1[s]) * inverse;
+            x[Count + s] = (a00[s] * b1[s] - b0[s] * a10[s]) * inverse;
+        }
+
+        return singular;
+    }
+
+    template<class T>
+    int SolveBatched3x3(int Count, const T* A, const T* b, T* x) {
+        const T* a[9];
+        for (int i = 0; i < 9; ++i) {
+            a[i] = A + i * Count;
+        }
+        const T* b0 = b;
+        const T* b1 = b + Count;
+        const T* b2 = b + 2 * Count;
+        int singular = 0;
+
+        #pragma omp simd reduction(+:singular)
+        for (int s = 0; s < Count; ++s) {
+            T m00 = a[0][s], m01 = a[1][s], m02 = a[2][s];
+            T m10 = a[3][s], m11 = a[4][s], m12 = a[5][s];
+            T m20 = a[6][s], m21 = a[7][s], m22 = a[8][s];
+
+            // cofactors of the first row
+            T c00 = m11 * m22 - m12 * m21;
+            T c01 = m12 * m20 - m10 * m22;
+            T c02 = m10 * m21 - m11 * m20;
+
+            T det = m00 * c00 + m01 * c01 + m02 * c02;
+            singular += det == T(0) ? 1 : 0;
+            T inverse = det != T(0) ? T(1) / det : T(0);
+
+            // x = adj(A) b / det
+            T r0 = b0[s], r1 = b1[s], r2 = b2[s];
+            x[s] = (c00 * r0 +
+                    (m02 * m21 - m01 * m22) * r1 +
+                    (m01 * m12 - m02 * m11) * r2) * inverse;
+            x[Count + s] = (c01 * r0 +
+                            (m00 * m22 - m02 * m20) * r1 +
+                            (m02 * m10 - m00 * m12) * r2) * inverse;
+            x[2 * Count + s] = (c02 * r0 +
+                                (m01 * m20 - m00 * m21) * r1 +
+                                (m00 * m11 - m01 * m10) * r2) * inverse;
+        }
+
+        return singular;
+    }
+
+    template<class T>
+    int SolveBatched4x4(int Count, const T* A, const T* b, T* x) {
+        const T* a[16];
+        for (int i = 0; i < 16; ++i) {
+            a[i] = A + i * Count;
+        }
+        int singular = 0;
+
+        #pragma omp simd reduction(+:singular)
+        for (int s = 0; s < Count; ++s) {
+            T m00 = a[0][s], m01 = a[1][s], m02 = a[2][s], m03 = a[3][s];
+            T m10 = a[4][s], m11 = a[5][s], m12 = a[6][s], m13 = a[7][s];
+            T m20 = a[8][s], m21 = a[9][s], m22 = a[10][s], m23 = a[11][s];
+            T m30 = a[12][s], m31 = a[13][s], m32 = a[14][s], m33 = a[15][s];
+
+            // 2x2 minors of the top and bottom row pairs (Laplace expansion)
+            T s0 = m00 * m11 - m10 * m01;
+            T s1 = m00 * m12 - m10 * m02;
+            T s2 = m00 * m13 - m10 * m03;
+            T s3 = m01 * m12 - m11 * m02;
+            T s4 = m01 * m13 - m11 * m03;
+            T s5 = m02 * m13 - m12 * m03;
+
+            T c5 = m22 * m33 - m32 * m23;
+            T c4 = m21 * m33 - m31 * m23;
+            T c3 = m21 * m32 - m31 * m22;
+            T c2 = m20 * m33 - m30 * m23;
+            T c1 = m20 * m32 - m30 * m22;
+            T c0 = m20 * m31 - m30 * m21;
+
+            T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            singular += det == T(0) ? 1 : 0;
+            T inverse = det != T(0) ? T(1) / det : T(0);
+
+            T r0 = b[s], r1 = b[Count + s], r2 = b[2 * Count + s], r3 = b[3 * Count + s];
+
+            T i00 = m11 * c5 - m12 * c4 + m13 * c3;
+            T i01 = -m01 * c5 + m02 * c4 - m03 * c3;
+            T i02 = m31 * s5 - m32 * s4 + m33 * s3;
+            T i03 = -m21 * s5 + m22 * s4 - m23 * s3;
+
+            T i10 = -m10 * c5 + m12 * c2 - m13 * c1;
+            T i11 = m00 * c5 - m02 * c2 + m03 * c1;
+            T i12 = -m30 * s5 + m32 * s2 - m33 * s1;
+            T i13 = m20 * s5 - m22 * s2 + m23 * s1;
+
+            T i20 = m10 * c4 - m11 * c2 + m13 * c0;
+            T i21 = -m00 * c4 + m01 * c2 - m03 * c0;
+            T i22 = m30 * s4 - m31 * s2 + m33 * s0;
+            T i23 = -m20 * s4 + m21 * s2 - m23 * s0;
+
+            T i30 = -m10 * c3 + m11 * c1 - m12 * c0;
+            T i31 = m00 * c3 - m01 * c1 + m02 * c0;
+            T i32 = -m30 * s3 + m31 * s1 - m32 * s0;
+            T i33 = m20 * s3 - m21 * s1 + m22 * s0;
+
+            x[s] = (i00 * r0 + i01 * r1 + i02 * r2 + i03 * r3) * inverse;
+            x[Count + s] = (i10 * r0 + i11 * r1 + i12 * r2 + i13 * r3) * inverse;
+            x[2 * Count + s] = (i20 * r0 + i21 * r1 + i22 * r2 + i23 * r3) * inverse;
+            x[3 * Count + s] = (i30 * r0 + i31 * r1 + i32 * r2 + i33 * r3) * inverse;
+        }
+
+        return singular;
+    }
+    // ===== BATCHED =====
+
+
+    template bool LUDecompose<float>(Matrix<float>&, std::vector<int>&, int*);
+    template bool LUDecompose<double>(Matrix<double>&, std::vector<int>&, int*);
+    template void LUSolve<float>(const Matrix<float>&, const std::vector<int>&, float*);
+    template void LUSolve<double>(const Matrix<double>&, const std::vector<int>&, double*);
+    template bool CholeskyDecompose<float>(Matrix<float>&);
+    template bool CholeskyDecompose<double>(Matrix<double>&);
+    template void CholeskySolve<float>(const Matrix<float>&, float*);
+    template void CholeskySolve<double>(const Matrix<double>&, double*);
+    template bool QRDecompose<float>(Matrix<float>&, std::vector<float>&);
+    template bool QRDecompose<double>(Matrix<double>&, std::vector<double>&);
+    template bool QRSolve<float>(const Matrix<float>&, const std::vector<float>&, float*);
+    template bool QRSolve<double>(const Matrix<double>&, const std::vector<double>&, double*);
+    template float Determinant<float>(const Matrix<float>&);
+    template double Determinant<double>(const Matrix<double>&);
+    template Matrix<float> Inverse<float>(const Matrix<float>&);
+    template Matrix<double> Inverse<double>(const Matrix<double>&);
+    template int SolveBatched2x2<float>(int, const float*, const float*, float*);
+    template int SolveBatched2x2<double>(int, const double*, const double*, double*);
+    template int SolveBatched3x3<float>(int, const float*, const float*, float*);
+    template int SolveBatched3x3<double>(int, const double*, const double*, double*);
+    template int SolveBatched4x4<float>(int, const float*, const float*, float*);
+    template int SolveBatched4x4<double>(int, const double*, const double*, double*);
+}
@@ -0,0 +1,92 @@
+/* Decompositions:
+ * LU with partial pivoting
+ * Cholesky
+ * Householder QR
+ * Batched 2x2, 3x3 and 4x4 solvers
+ * */
+
+#ifndef MATH_DECOMPOSITION_H
+#define MATH_DECOMPOSITION_H
+
+#include <vector>
+#include "MATH.h"
+
+namespace Math {
+    // ===== LU =====
+    // PA = LU, in place: U is the upper triangle of A, L (unit diagonal) the
+    // part below it. Pivots[k] is the row swapped with row k at step k.
+    // Panels of LUBlockSize columns are factored first, then the trailing
+    // matrix is updated row by row so every pass streams contiguous memory.
+    // Returns false for a non square or singular matrix.
+    const int LUBlockSize = 32;
+
+    template<class T>
+    bool LUDecompose(Matrix<T>& A, std::vector<int>& Pivots, int* Sign = nullptr);
+
+    // Solves A x = b with the output of LUDecompose, b is overwritten by x
+    template<class T>
+    void LUSolve(const Matrix<T>& LU, const std::vector<int>& Pivots, T* b);
+    // ===== LU =====
+
+
+
+    // ===== CHOLESKY =====
+    // A = L L^T for symmetric positive definite A, in place: L is the lower
+    // triangle, the upper one is cleared. Only the lower triangle of A is read.
+    // Returns false when A is not square or not positive definite.
+    template<class T>
+    bool CholeskyDecompose(Matrix<T>& A);
+
+    // Solves A x = b with the output of CholeskyDecompose, b is overwritten by x
+    template<class T>
+    void CholeskySolve(const Matrix<T>& L, T* b);
+    // ===== CHOLESKY =====
+
+
+
+    // ===== QR =====
+    // A = QR for N x M, N >= M, in place: R is the upper triangle, the
+    // Householder vectors v (v[0] = 1 implied) sit below the diagonal and
+    // Q = H(0)...H(M-1) with H(k) = I - Tau[k] v v^T.
+    template<class T>
+    bool QRDecompose(Matrix<T>& A, std::vector<T>& Tau);
+
+    // Least squares solution of A x = b with the output of QRDecompose.
+    // b has N elements and is overwritten, x is stored in its first M.
+    // Returns false when R is singular.
+    template<class T>
+    bool QRSolve(const Matrix<T>& QR, const std::vector<T>& Tau, T* b);
+    // ===== QR =====
+
+
+
+    // returns 0 for a singular or non square matrix
+    template<class T>
+    T Determinant(const Matrix<T>& A);
+
+    // returns an empty matrix for a singular or non square matrix
+    template<class T>
+    Matrix<T> Inverse(const Matrix<T>& A);
+
+
+
+    // ===== BATCHED =====
+    // Solve Count independent small systems A x = b at once. The data is
+    // laid out system-minor (structure of arrays) so the same element of every
+    // system is contiguous and each step vectorizes across systems:
+    //   A(row, col) of system s: A[(row * Size + col) * Count + s]
+    //   b(row) of system s:      b[row * Count + s]
+    // Cramer's rule / cofactors keep the kernels branch free. A system with a
+    // zero determinant gets x = 0. Returns the number of such systems.
+    template<class T>
+    int SolveBatched2x2(int Count, const T* A, const T* b, T* x);
+
+    template<class T>
+    int SolveBatched3x3(int Count, const T* A, const T* b, T* x);
+
+    template<class T>
+    int SolveBatched4x4(int Count, const T* A, const T* b, T* x);
+    // ===== BATCHED =====
+}
+
+#endif //MATH_DECOMPOSITION_H
@@ -0,0 +1,210 @@
+/* Scalar templated geometry:
+ * Vector, rectangle and convex polygon tests for any scalar type
+ * Conversion of fixed point bounds for the QuadTree
+ *
+ * SVector_2D, CRectangle and CPolygon in MATH.h stay the canonical float
+ * API, the QuadTree, ShapeRegistry and GJK are written against them. The
+ * types here mirror their conventions for other scalars (Math::Fixed16_16,
+ * Math::Fixed32_32) and have to follow any change made there:
+ *   TopLeft is the minimum corner of a rectangle
+ *   IsPointInsideRect includes the edges, DoRectanglesOverlap doesn't
+ *   touching convex polygons overlap, like DoPolygonsOverlap
+ * Tests/FixedGeometryTest checks the float instantiations against the
+ * canonical functions.
+ * */
+
+#ifndef MATH_FIXEDGEOMETRY_H
+#define MATH_FIXEDGEOMETRY_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "FixedPoint.h"
+#include "MATH.h"
+
+namespace Geometry_2D {
+    // ===== VECTOR 2D =====
+    // SVector_2D with the scalar as a parameter. With Math::Fixed16_16 or
+    // Math::Fixed32_32 every result is bit-identical on every machine.
+    template<class T>
+    struct TVector_2D {
+        T X, Y;
+
+        inline TVector_2D() : X(), Y() {}
+        inline TVector_2D(T x, T y) : X(x), Y(y) {}
+
+        inline T Magnitude() const {
+            using Math::Sqrt;
+            return Sqrt(X * X + Y * Y);
+        }
+
+        inline TVector_2D& operator+=(const TVector_2D& Vector2) {
+            X += Vector2.X;
+            Y += Vector2.Y;
+            return *this;
+        }
+        inline TVector_2D& operator-=(const TVector_2D& Vector2) {
+            X -= Vector2.X;
+            Y -= Vector2.Y;
+            return *this;
+        }
+        inline TVector_2D& operator*=(T Value) {
+            X *= Value;
+            Y *= Value;
+            return *this;
+        }
+    };
+
+    template<class T>
+    inline TVector_2D<T> operator+(TVector_2D<T> Vector1, const TVector_2D<T>& Vector2) { return Vector1 += Vector2; }
+    template<class T>
+    inline TVector_2D<T> operator-(TVector_2D<T> Vector1, const TVector_2D<T>& Vector2) { return Vector1 -= Vector2; }
+    template<class T>
+    inline TVector_2D<T> operator*(TVector_2D<T> Vector1, T Value) { return Vector1 *= Value; }
+    template<class T>
+    inline TVector_2D<T> operator*(T Value, TVector_2D<T> Vector1) { return Vector1 *= Value; }
+
+    template<class T>
+    inline bool operator==(const TVector_2D<T>& a, const TVector_2D<T>& b) { return a.X == b.X && a.Y == b.Y; }
+    template<class T>
+    inline bool operator!=(const TVector_2D<T>& a, const TVector_2D<T>& b) { return !(a == b); }
+
+    template<class T>
+    inline T DotProduct(const TVector_2D<T>& Vector1, const TVector_2D<T>& Vector2) {
+        return Vector1.X * Vector2.X + Vector1.Y * Vector2.Y;
+    }
+
+    // z of the 3D cross product, > 0 when Vector2 is counter clockwise from Vector1
+    template<class T>
+    inline T CrossProduct(const TVector_2D<T>& Vector1, const TVector_2D<T>& Vector2) {
+        return Vector1.X * Vector2.Y - Vector1.Y * Vector2.X;
+    }
+    // ===== VECTOR 2D =====
+
+
+
+    // ===== RECTANGLE =====
+    // Same layout and rules as CRectangle: TopLeft is the minimum corner
+    template<class T>
+    struct TRectangle {
+        TVector_2D<T> TopLeft;
+        TVector_2D<T> BottomRight;
+
+        inline TRectangle() {}
+        inline TRectangle(const TVector_2D<T>& TL, const TVector_2D<T>& BR) : TopLeft(TL), BottomRight(BR) {}
+
+        inline TVector_2D<T> GetSize() const { return BottomRight - TopLeft; }
+    };
+
+    template<class T>
+    inline bool IsPointInsideRect(const TVector_2D<T>& Point, const TRectangle<T>& Rect) {
+        return Point.X >= Rect.TopLeft.X && Point.X <= Rect.BottomRight.X &&
+               Point.Y >= Rect.TopLeft.Y && Point.Y <= Rect.BottomRight.Y;
+    }
+
+    // touching edges don't overlap, like DoRectanglesOverlap
+    template<class T>
+    inline bool DoRectanglesOverlap(const TRectangle<T>& R1, const TRectangle<T>& R2) {
+        return R1.TopLeft.X < R2.BottomRight.X && R1.BottomRight.X > R2.TopLeft.X &&
+               R1.TopLeft.Y < R2.BottomRight.Y && R1.BottomRight.Y > R2.TopLeft.Y;
+    }
+
+    template<class T>
+    inline TRectangle<T> CreateRectangleIncludingTwoPoints(const TVector_2D<T>& Point1, const TVector_2D<T>& Point2) {
+        return TRectangle<T>(TVector_2D<T>(Point1.X < Point2.X ? Point1.X : Point2.X,
+                                           Point1.Y < Point2.Y ? Point1.Y : Point2.Y),
+                             TVector_2D<T>(Point1.X > Point2.X ? Point1.X : Point2.X,
+                                           Point1.Y > Point2.Y ? Point1.Y : Point2.Y));
+    }
+
+    // Float box that contains Rect, for inserting and querying a QuadTree.
+    // Corners are rounded outwards, so the QuadTree stays a conservative
+    // broad phase: it only compares the boxes, and the candidates it returns
+    // don't depend on the float rounding. The exact test is then done on
+    // the fixed point shapes.
+    template<int F, class S, class W, class U>
+    inline CRectangle ToRectangle(const TRectangle<Math::SFixed<F, S, W, U> >& Rect) {
+        const float lowest = std::numeric_limits<float>::lowest();
+        const float highest = std::numeric_limits<float>::max();
+        return CRectangle(SVector_2D(std::nextafter(Rect.TopLeft.X.ToFloat(), lowest),
+                                     std::nextafter(Rect.TopLeft.Y.ToFloat(), lowest)),
+                          SVector_2D(std::nextafter(Rect.BottomRight.X.ToFloat(), highest),
+                                     std::nextafter(Rect.BottomRight.Y.ToFloat(), highest)));
+    }
+
+    inline CRectangle ToRectangle(const TRectangle<float>& Rect) {
+        return CRectangle(SVector_2D(Rect.TopLeft.X, Rect.TopLeft.Y),
+                          SVector_2D(Rect.BottomRight.X, Rect.BottomRight.Y));
+    }
+    // ===== RECTANGLE =====
+
+
+
+    // ===== POLYGON =====
+    template<class T>
+    TRectangle<T> GetBounds(const TVector_2D<T>* Vertices, size_t Count) {
+        if (Count == 0) return TRectangle<T>();
+
+        TRectangle<T> bounds(Vertices[0], Vertices[0]);
+        for (size_t i = 1; i < Count; ++i) {
+            if (Vertices[i].X < bounds.TopLeft.X) bounds.TopLeft.X = Vertices[i].X;
+            if (Vertices[i].Y < bounds.TopLeft.Y) bounds.TopLeft.Y = Vertices[i].Y;
+            if (Vertices[i].X > bounds.BottomRight.X) bounds.BottomRight.X = Vertices[i].X;
+            if (Vertices[i].Y > bounds.BottomRight.Y) bounds.BottomRight.Y = Vertices[i].Y;
+        }
+        return bounds;
+    }
+
+    // Dot product for projections, exact for fixed point: the raw products are
+    // summed in Wide, so nothing is rounded and only the edge subtraction can wrap
+    template<class T>
+    inline T WideDotProduct(const TVector_2D<T>& Vector1, const TVector_2D<T>& Vector2) {
+        return DotProduct(Vector1, Vector2);
+    }
+
+    template<int F, class S, class W, class U>
+    inline W WideDotProduct(const TVector_2D<Math::SFixed<F, S, W, U> >& Vector1,
+                            const TVector_2D<Math::SFixed<F, S, W, U> >& Vector2) {
+        return W(Vector1.X.Raw) * W(Vector2.X.Raw) + W(Vector1.Y.Raw) * W(Vector2.Y.Raw);
+    }
+
+    // Separating axis test for two convex polygons, vertices in either winding.
+    // Fixed point projections are exact as long as every coordinate is under
+    // half the range, |x| < 16384 for Fixed16_16 and |x| < 1.07e9 for Fixed32_32,
+    // so edges don't wrap.
+    template<class T>
+    bool DoConvexPolygonsOverlap(const TVector_2D<T>* Vertices1, size_t Count1,
+                                 const TVector_2D<T>* Vertices2, size_t Count2) {
+        if (Count1 < 3 || Count2 < 3) return false;
+
+        for (int side = 0; side < 2; ++side) {
+            const TVector_2D<T>* edges = side == 0 ? Vertices1 : Vertices2;
+            size_t edgeCount = side == 0 ? Count1 : Count2;
+
+            for (size_t i = 0; i < edgeCount; ++i) {
+                TVector_2D<T> edge = edges[(i + 1) % edgeCount] - edges[i];
+                TVector_2D<T> axis(-edge.Y, edge.X);
+
+                auto min1 = WideDotProduct(axis, Vertices1[0]), max1 = min1;
+                for (size_t j = 1; j < Count1; ++j) {
+                    auto projection = WideDotProduct(axis, Vertices1[j]);
+                    if (projection < min1) min1 = projection;
+                    if (projection > max1) max1 = projection;
+                }
+
+                auto min2 = WideDotProduct(axis, Vertices2[0]), max2 = min2;
+                for (size_t j = 1; j < Count2; ++j) {
+                    auto projection = WideDotProduct(axis, Vertices2[j]);
+                    if (projection < min2) min2 = projection;
+                    if (projection > max2) max2 = projection;
+                }
+
+                if (max1 < min2 || max2 < min1) return false;
+            }
+        }
+        return true;
+    }
+    // ===== POLYGON =====
+}
+
+#endif //MATH_FIXEDGEOMETRY_H
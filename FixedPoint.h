@@ -0,0 +1,235 @@
+/* Fixed point:
+ * Q16.16 and Q32.32 numbers
+ * Deterministic Sqrt, Sin, Cos, Atan2
+ * */
+
+#ifndef MATH_FIXEDPOINT_H
+#define MATH_FIXEDPOINT_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+namespace Math {
+    // ===== FIXED =====
+    // Signed fixed point number with FracBits fractional bits. Every operation
+    // is done on integers, so results are bit-identical on every compiler,
+    // platform and optimization level (lockstep simulations).
+    // Overflow wraps around instead of being undefined.
+    // Wide holds the product of two raw values, UWide is its unsigned twin.
+    template<int FracBits, class Storage, class Wide, class UWide>
+    struct SFixed {
+        typedef typename std::make_unsigned<Storage>::type UStorage;
+        static const int Fraction = FracBits;
+
+        Storage Raw;
+
+        inline SFixed() : Raw(0) {}
+        // integers outside the range wrap like every other operation
+        inline explicit SFixed(int Value) : Raw(Storage(UStorage(Storage(Value)) << FracBits)) {}
+
+        inline static SFixed FromRaw(Storage Value) {
+            SFixed result;
+            result.Raw = Value;
+            return result;
+        }
+
+        // For loading data and constants only, the simulation itself should
+        // never go through floating point
+        inline static SFixed FromDouble(double Value) {
+            return FromRaw(Storage(std::llround(Value * double(Storage(1) << FracBits))));
+        }
+
+        inline double ToDouble() const { return double(Raw) / double(Storage(1) << FracBits); }
+        inline float ToFloat() const { return float(ToDouble()); }
+        // rounds towards negative infinity
+        inline int ToInt() const { return int(Raw >> FracBits); }
+
+        inline static SFixed Max() { return FromRaw(std::numeric_limits<Storage>::max()); }
+        inline static SFixed Min() { return FromRaw(std::numeric_limits<Storage>::min()); }
+        inline static SFixed Epsilon() { return FromRaw(1); }
+
+        // OPERATORS
+        inline SFixed operator-() const { return FromRaw(Storage(UStorage(0) - UStorage(Raw))); }
+
+        inline SFixed& operator+=(SFixed Value) {
+            Raw = Storage(UStorage(Raw) + UStorage(Value.Raw));
+            return *this;
+        }
+        inline SFixed& operator-=(SFixed Value) {
+            Raw = Storage(UStorage(Raw) - UStorage(Value.Raw));
+            return *this;
+        }
+        // rounds to nearest
+        inline SFixed& operator*=(SFixed Value) {
+            Wide product = Wide(Raw) * Wide(Value.Raw);
+            Raw = Storage((product + (Wide(1) << (FracBits - 1))) >> FracBits);
+            return *this;
+        }
+        // truncates, division by zero saturates
+        inline SFixed& operator/=(SFixed Value) {
+            if (Value.Raw == 0) {
+                *this = Raw >= 0 ? Max() : Min();
+                return *this;
+            }
+            Raw = Storage((Wide(Raw) * (Wide(1) << FracBits)) / Wide(Value.Raw));
+            return *this;
+        }
+    };
+
+    template<int F, class S, class W, class U>
+    inline SFixed<F, S, W, U> operator+(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a += b; }
+    template<int F, class S, class W, class U>
+    inline SFixed<F, S, W, U> operator-(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a -= b; }
+    template<int F, class S, class W, class U>
+    inline SFixed<F, S, W, U> operator*(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a *= b; }
+    template<int F, class S, class W, class U>
+    inline SFixed<F, S, W, U> operator/(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a /= b; }
+
+    template<int F, class S, class W, class U>
+    inline bool operator==(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a.Raw == b.Raw; }
+    template<int F, class S, class W, class U>
+    inline bool operator!=(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a.Raw != b.Raw; }
+    template<int F, class S, class W, class U>
+    inline bool operator<(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a.Raw < b.Raw; }
+    template<int F, class S, class W, class U>
+    inline bool operator<=(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a.Raw <= b.Raw; }
+    template<int F, class S, class W, class U>
+    inline bool operator>(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a.Raw > b.Raw; }
+    template<int F, class S, class W, class U>
+    inline bool operator>=(SFixed<F, S, W, U> a, SFixed<F, S, W, U> b) { return a.Raw >= b.Raw; }
+
+    template<int F, class S, class W, class U>
+    std::ostream& operator<<(std::ostream& out, SFixed<F, S, W, U> Value) {
+        return out << Value.ToDouble();
+    }
+
+    // Q16.16: range +-32768, resolution 1.5e-5
+    typedef SFixed<16, int32_t, int64_t, uint64_t> Fixed16_16;
+#if defined(__SIZEOF_INT128__)
+    // Q32.32: range +-2.1e9, resolution 2.3e-10
+    typedef SFixed<32, int64_t, __int128, unsigned __int128> Fixed32_32;
+#endif
+    // ===== FIXED =====
+
+
+
+    // ===== FUNCTIONS =====
+    // Largest error against libm over [-20, 20]:
+    //                Q16.16    Q32.32
+    //   Sqrt         1.5e-5    2.3e-10  (rounded down to the last bit)
+    //   Sin, Cos     5.2e-5    1.1e-9
+    //   Atan2        3.0e-5    2.7e-9
+
+    // Pi rounded to the nearest FracBits value, from pi * 2^61
+    template<class Fixed>
+    inline Fixed FixedPi() {
+        const uint64_t PiQ61 = 0x6487ED5110B4611AULL;
+        const int shift = 61 - Fixed::Fraction;
+        return Fixed::FromRaw(typename Fixed::UStorage((PiQ61 + (uint64_t(1) << (shift - 1))) >> shift));
+    }
+
+    // so generic geometry can call Sqrt for any scalar
+    inline float Sqrt(float Value) { return std::sqrt(Value); }
+    inline double Sqrt(double Value) { return std::sqrt(Value); }
+
+    template<int F, class S, class W, class U>
+    inline SFixed<F, S, W, U> Abs(SFixed<F, S, W, U> Value) {
+        return Value.Raw < 0 ? -Value : Value;
+    }
+
+    // Bit by bit integer square root of Raw << F, negative values give 0
+    template<int F, class S, class W, class U>
+    SFixed<F, S, W, U> Sqrt(SFixed<F, S, W, U> Value) {
+        if (Value.Raw <= 0) return SFixed<F, S, W, U>();
+
+        U remainder = U(Value.Raw) << F;
+        U root = 0;
+        U bit = U(1) << (sizeof(U) * 8 - 2);
+        while (bit > remainder) bit >>= 2;
+
+        while (bit != 0) {
+            if (remainder >= root + bit) {
+                remainder -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return SFixed<F, S, W, U>::FromRaw(S(root));
+    }
+
+    // Taylor series up to x^13 after reducing the angle to [-pi/2, pi/2]
+    template<int F, class S, class W, class U>
+    SFixed<F, S, W, U> Sin(SFixed<F, S, W, U> Angle) {
+        typedef SFixed<F, S, W, U> Fixed;
+        const Fixed pi = FixedPi<Fixed>();
+        const Fixed twoPi = pi + pi;
+        const Fixed halfPi = Fixed::FromRaw(pi.Raw / 2);
+
+        // [-pi, pi)
+        S turns = (Angle + pi).Raw / twoPi.Raw;
+        Fixed x = Angle - Fixed::FromRaw(turns * twoPi.Raw);
+        while (x >= pi) x -= twoPi;
+        while (x < -pi) x += twoPi;
+
+        // sin(pi - x) = sin(x)
+        if (x > halfPi) x = pi - x;
+        if (x < -halfPi) x = -pi - x;
+
+        Fixed x2 = x * x;
+        // Horner form of x (1 - x^2/(2*3) (1 - x^2/(4*5) (1 - ...)))
+        Fixed sum(1);
+        for (int n = 12; n >= 2; n -= 2) {
+            sum = Fixed(1) - x2 * sum / Fixed(n * (n + 1));
+        }
+        return x * sum;
+    }
+
+    template<int F, class S, class W, class U>
+    SFixed<F, S, W, U> Cos(SFixed<F, S, W, U> Angle) {
+        typedef SFixed<F, S, W, U> Fixed;
+        return Sin(Angle + Fixed::FromRaw(FixedPi<Fixed>().Raw / 2));
+    }
+
+    // Angle of (X, Y) in [-pi, pi], 0 for (0, 0)
+    template<int F, class S, class W, class U>
+    SFixed<F, S, W, U> Atan2(SFixed<F, S, W, U> Y, SFixed<F, S, W, U> X) {
+        typedef SFixed<F, S, W, U> Fixed;
+        const Fixed pi = FixedPi<Fixed>();
+        const Fixed halfPi = Fixed::FromRaw(pi.Raw / 2);
+        const Fixed quarterPi = Fixed::FromRaw(pi.Raw / 4);
+
+        if (X.Raw == 0 && Y.Raw == 0) return Fixed();
+
+        Fixed absX = Abs(X);
+        Fixed absY = Abs(Y);
+        // z in [0, 1]
+        bool swapped = absY > absX;
+        Fixed z = swapped ? absX / absY : absY / absX;
+
+        // atan(z) = pi/4 + atan((z - 1) / (z + 1)), so the series argument stays under tan(pi/8)
+        bool shifted = z > Fixed::FromRaw(S((W(Fixed(1).Raw) * 27146) >> 16)); // tan(pi/8) ~ 0.41421
+        Fixed t = shifted ? (z - Fixed(1)) / (z + Fixed(1)) : z;
+
+        // Taylor series t - t^3/3 + t^5/5 - ... up to t^17
+        Fixed t2 = t * t;
+        Fixed sum = Fixed(1) / Fixed(17);
+        for (int n = 15; n >= 1; n -= 2) {
+            sum = Fixed(1) / Fixed(n) - t2 * sum;
+        }
+        Fixed angle = t * sum;
+        if (shifted) angle += quarterPi;
+
+        if (swapped) angle = halfPi - angle;
+        if (X.Raw < 0) angle = pi - angle;
+        if (Y.Raw < 0) angle = -angle;
+        return angle;
+    }
+    // ===== FUNCTIONS =====
+}
+
+#endif //MATH_FIXEDPOINT_H
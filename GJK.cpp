@@ -26,5 +26,47 @@ std::vector<SVector_2D> Collision::MinkowskiDiff(const std::vector<SVector_2D>&
         }
     }
 
+    return SumResult;
+}
+
+std::vector<SVector_2D> Collision::MinkowskiSum(const Geometry_2D::CPolygon& Polygon1,
+                                                const Geometry_2D::CPolygon& Polygon2) {
+    int n1 = Polygon1.GetVertexCount();
+    int n2 = Polygon2.GetVertexCount();
+    const float* x1 = Polygon1.GetX();
+    const float* y1 = Polygon1.GetY();
+    const float* x2 = Polygon2.GetX();
+    const float* y2 = Polygon2.GetY();
+
+    std::vector<SVector_2D> SumResult;
+    SumResult.reserve(size_t(n1) * n2);
+
+    for (int i = 0; i < n1; ++i) {
+        for (int j = 0; j < n2; ++j) {
+            SumResult.push_back(SVector_2D(x1[i] + x2[j], y1[i] + y2[j]));
+        }
+    }
+
+    return SumResult;
+}
+
+std::vector<SVector_2D> Collision::MinkowskiDiff(const Geometry_2D::CPolygon& Polygon1,
+                                                 const Geometry_2D::CPolygon& Polygon2) {
+    int n1 = Polygon1.GetVertexCount();
+    int n2 = Polygon2.GetVertexCount();
+    const float* x1 = Polygon1.GetX();
+    const float* y1 = Polygon1.GetY();
+    const float* x2 = Polygon2.GetX();
+    const float* y2 = Polygon2.GetY();
+
+    std::vector<SVector_2D> SumResult;
+    SumResult.reserve(size_t(n1) * n2);
+
+    for (int i = 0; i < n1; ++i) {
+        for (int j = 0; j < n2; ++j) {
+            SumResult.push_back(SVector_2D(x1[i] - x2[j], y1[i] - y2[j]));
+        }
+    }
+
     return SumResult;
 }
\ No newline at end of file
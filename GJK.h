@@ -1,6 +1,9 @@
 #ifndef MATH_GJK_H
 #define MATH_GJK_H
 
+#include <cstddef>
+#include <functional>
+#include <type_traits>
 #include <vector>
 #include "MATH.h"
 
@@ -14,6 +17,89 @@ namespace Collision {
     // Minkowski difference (or geometric difference)
     std::vector<SVector_2D> MinkowskiDiff(const std::vector<SVector_2D>& Set1,
                                           const std::vector<SVector_2D>& Set2);
+
+    // Same as above, reading the vertices of the polygons in place
+    std::vector<SVector_2D> MinkowskiSum(const Geometry_2D::CPolygon& Polygon1,
+                                         const Geometry_2D::CPolygon& Polygon2);
+
+    std::vector<SVector_2D> MinkowskiDiff(const Geometry_2D::CPolygon& Polygon1,
+                                          const Geometry_2D::CPolygon& Polygon2);
+
+
+    // ===== STREAMING =====
+    // Streaming variants for inputs that don't fit in memory. Results are handed
+    // to Out(const Point* Points, size_t Count) in chunks of at most
+    // StreamChunkSize points, so peak memory doesn't depend on the input size.
+    // Set2 is walked once per point of Set1, so it has to be re-readable
+    // (a container, or a pointer range into a memory mapped file).
+    // Point is the type of the inputs: SVector_2D, or TVector_2D<T> from
+    // FixedGeometry.h for deterministic fixed point sums.
+    const size_t StreamChunkSize = 4096;
+
+    // Fills Buffer with at most Capacity points and returns how many were written, 0 once exhausted
+    typedef std::function<size_t(SVector_2D* Buffer, size_t Capacity)> PointSourceFunction;
+
+    template<class Operation, class InputIt, class ForwardIt, class Sink>
+    void MinkowskiStream(InputIt First1, InputIt Last1,
+                         ForwardIt First2, ForwardIt Last2,
+                         Operation Op, Sink&& Out) {
+        typedef typename std::decay<decltype(Op(*First1, *First2))>::type Point;
+        Point Chunk[StreamChunkSize];
+        size_t Count = 0;
+
+        for (; First1 != Last1; ++First1) {
+            const auto& PointOfSet1 = *First1;
+            for (ForwardIt It = First2; It != Last2; ++It) {
+                Chunk[Count++] = Op(PointOfSet1, *It);
+                if (Count == StreamChunkSize) {
+                    Out(static_cast<const Point*>(Chunk), Count);
+                    Count = 0;
+                }
+            }
+        }
+
+        if (Count > 0) Out(static_cast<const Point*>(Chunk), Count);
+    }
+
+    template<class InputIt, class ForwardIt, class Sink>
+    void MinkowskiSum(InputIt First1, InputIt Last1,
+                      ForwardIt First2, ForwardIt Last2,
+                      Sink&& Out) {
+        MinkowskiStream(First1, Last1, First2, Last2,
+                        [](const auto& a, const auto& b) { return a + b; },
+                        Out);
+    }
+
+    template<class InputIt, class ForwardIt, class Sink>
+    void MinkowskiDiff(InputIt First1, InputIt Last1,
+                       ForwardIt First2, ForwardIt Last2,
+                       Sink&& Out) {
+        MinkowskiStream(First1, Last1, First2, Last2,
+                        [](const auto& a, const auto& b) { return a - b; },
+                        Out);
+    }
+
+    // Set1 is pulled from Source1 one chunk at a time
+    template<class ForwardIt, class Sink>
+    void MinkowskiSum(const PointSourceFunction& Source1,
+                      ForwardIt First2, ForwardIt Last2,
+                      Sink&& Out) {
+        SVector_2D Input[StreamChunkSize];
+        for (size_t Read = Source1(Input, StreamChunkSize); Read > 0; Read = Source1(Input, StreamChunkSize)) {
+            MinkowskiSum(Input, Input + Read, First2, Last2, Out);
+        }
+    }
+
+    template<class ForwardIt, class Sink>
+    void MinkowskiDiff(const PointSourceFunction& Source1,
+                       ForwardIt First2, ForwardIt Last2,
+                       Sink&& Out) {
+        SVector_2D Input[StreamChunkSize];
+        for (size_t Read = Source1(Input, StreamChunkSize); Read > 0; Read = Source1(Input, StreamChunkSize)) {
+            MinkowskiDiff(Input, Input + Read, First2, Last2, Out);
+        }
+    }
+    // ===== STREAMING =====
 }
 
 #endif //MATH_GJK_H
@@ -1,21 +1,10 @@
 #include "MATH.h"
 #include <cmath>
 #include "cassert"
+#include <algorithm>
+#include <limits>
 
 namespace Geometry_2D {
-    SVector_2D::SVector_2D(float DefaultValue):
-    X(DefaultValue),
-    Y(DefaultValue) {}
-
-    SVector_2D::SVector_2D(float x, float y) :
-    X(x),
-    Y(y) {}
-
-    SVector_2D::SVector_2D(const SVector_2D& Vector_2D) {
-        X = Vector_2D.X;
-        Y = Vector_2D.Y;
-    }
-
     float SVector_2D::Magnitude() const {
         return float(sqrt(double(X*X + Y*Y)));
     }
@@ -28,177 +17,299 @@ namespace Geometry_2D {
     }
 
 
-    // OPERATORS
-    SVector_2D& SVector_2D::operator=(const SVector_2D& Vector2) {
-        if(this == &Vector2) return *this;
-
-        this->X = Vector2.X;
-        this->Y = Vector2.Y;
-        return *this;
+    std::ostream& operator<<(std::ostream& out, const SVector_2D& Vector) {
+        out << "Vector (" << Vector.X << ", " << Vector.Y << ")\n";
+        return out;
     }
 
-    SVector_2D& SVector_2D::operator+=(const SVector_2D &Vector2) {
-        this->X += Vector2.X;
-        this->Y += Vector2.Y;
-        return *this;
-    }
-    SVector_2D& SVector_2D::operator-=(const SVector_2D &Vector2) {
-        this->X -= Vector2.X;
-        this->Y -= Vector2.Y;
-        return *this;
+    float AngleBetweenVectors(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return std::acos((DotProduct(Vector1, Vector2))/(Vector1.Magnitude()*Vector2.Magnitude()));
     }
-    SVector_2D& SVector_2D::operator*=(float Value) {
-        this->X *= Value;
-        this->Y *= Value;
 
-        return *this;
-    }
-    SVector_2D& SVector_2D::operator/=(float Value) {
-        this->X /= Value;
-        this->Y /= Value;
 
-        return *this;
-    }
 
-    bool SVector_2D::operator()(const SVector_2D &Vector1, const SVector_2D &Vector2) const {
-        return Vector1 == Vector2;
+    // ===== Circle =====
+    float CCircle::GetRadius() const {
+        return Radius;
     }
 
-    SVector_2D operator+(const SVector_2D& Vector1, const SVector_2D& Vector2) {
-        return SVector_2D(Vector1.X + Vector2.X, Vector1.Y + Vector2.Y);
-    }
-    SVector_2D operator-(const SVector_2D& Vector1, const SVector_2D& Vector2) {
-        return SVector_2D(Vector1.X - Vector2.X, Vector1.Y - Vector2.Y);
+    SVector_2D CCircle::GetCenter() const {
+        return Center;
     }
+    // ===== Circle =====
 
-    SVector_2D operator*(const SVector_2D& Vector1, float Value) {
-        return SVector_2D(Vector1.X * Value, Vector1.Y * Value);
-    }
-    SVector_2D operator*(float Value, const SVector_2D &Vector1) {
-        return Vector1 * Value;
-    }
 
-    bool operator==(const SVector_2D &Vector1, const SVector_2D &Vector2) {
-        return Vector1.X == Vector2.X && Vector1.Y == Vector2.Y;
-    }
 
-    std::ostream& operator<<(std::ostream& out, const SVector_2D& Vector) {
-        out << "Vector (" << Vector.X << ", " << Vector.Y << ")\n";
-        return out;
-    }
+    // [POLYGONS]
+    // ===== BASE POLYGON =====
+    CPolygon::CPolygon(EFIGURE_TYPE Type) : CFigure(Type),
+                                            VertexCount(0),
+                                            Capacity(InlineCapacity),
+                                            Data(InlineData),
+                                            Convex(true) {}
 
-    bool operator!=(SVector_2D a, SVector_2D b) {
-        return !(a == b);
+    CPolygon::CPolygon(const SVector_2D* Vertices, int Count, EFIGURE_TYPE Type) : CPolygon(Type) {
+        SetVertices(Vertices, Count);
     }
 
-    bool operator<(SVector_2D a, SVector_2D b) {
-        return std::tie(a.X, a.Y) < std::tie(b.X, b.Y);
+    CPolygon::CPolygon(const std::vector<SVector_2D>& Vertices, EFIGURE_TYPE Type) : CPolygon(Type) {
+        SetVertices(Vertices.data(), int(Vertices.size()));
     }
 
-
-
-    float DotProduct(const SVector_2D& Vector1, const SVector_2D& Vector2) {
-        return Vector1.X*Vector2.X + Vector1.Y*Vector2.Y;
+    CPolygon::CPolygon(const CPolygon& Polygon) : CPolygon(Polygon.Type) {
+        *this = Polygon;
     }
 
-    float AngleBetweenVectors(const SVector_2D& Vector1, const SVector_2D& Vector2) {
-        return std::acos((DotProduct(Vector1, Vector2))/(Vector1.Magnitude()*Vector2.Magnitude()));
+    CPolygon::~CPolygon() {
+        if (Data != InlineData) delete[] Data;
     }
 
+    CPolygon& CPolygon::operator=(const CPolygon& Polygon) {
+        if (this == &Polygon) return *this;
 
+        Type = Polygon.Type;
+        Reserve(Polygon.VertexCount);
+        VertexCount = Polygon.VertexCount;
+        for (int i = 0; i < 4; ++i) {
+            std::copy(Polygon.Data + i * Polygon.Capacity,
+                      Polygon.Data + i * Polygon.Capacity + VertexCount,
+                      Data + i * Capacity);
+        }
+        Bounds = Polygon.Bounds;
+        Centroid = Polygon.Centroid;
+        Convex = Polygon.Convex;
+        return *this;
+    }
 
-    // [POLYGONS]
+    void CPolygon::Reserve(int Count) {
+        if (Count <= Capacity) return;
 
-    // ===== RECTANGLE =====
-    SVector_2D CRectangle::GetSize() const  {
-        return SVector_2D(BottomRight.X - TopLeft.X,
-                          BottomRight.Y - TopLeft.Y);
+        if (Data != InlineData) delete[] Data;
+        Data = new float[4 * Count];
+        Capacity = Count;
     }
 
+    void CPolygon::SetVertices(const SVector_2D* Vertices, int Count) {
+        if (Count < 0) Count = 0;
+        Reserve(Count);
+        VertexCount = Count;
+
+        float* x = Data;
+        float* y = Data + Capacity;
+        for (int i = 0; i < Count; ++i) {
+            x[i] = Vertices[i].X;
+            y[i] = Vertices[i].Y;
+        }
 
-    bool IsPointInsideRect(const SVector_2D& Point, const CRectangle& Rect) {
-        return (Point.X >= Rect.TopLeft.X && Point.X <= Rect.BottomRight.X) &&
-        (Point.Y >= Rect.TopLeft.Y && Point.Y <= Rect.BottomRight.Y);
+        UpdateCache();
     }
 
-    bool DoRectanglesOverlap(const CRectangle& R1, const CRectangle& R2) {
-        if (DoRectanglesOverlap_X(R1, R2) &&
-        DoRectanglesOverlap_Y(R1, R2)) return true;
+    void CPolygon::UpdateCache() {
+        const float* x = GetX();
+        const float* y = GetY();
+        float* normalX = Data + 2 * Capacity;
+        float* normalY = Data + 3 * Capacity;
+        int n = VertexCount;
 
-        return false;
-    }
+        if (n == 0) {
+            Bounds = CRectangle();
+            Centroid = ZeroVector_2D;
+            Convex = true;
+            return;
+        }
 
-    bool DoRectanglesOverlap_X(const CRectangle& R1, const CRectangle& R2) {
-        if ((R1.TopLeft.X < R2.BottomRight.X  ) && (R1.BottomRight.X > R2.TopLeft.X  )) {
-            return true;
+        SVector_2D min(x[0], y[0]);
+        SVector_2D max(x[0], y[0]);
+        for (int i = 1; i < n; ++i) {
+            min.X = x[i] < min.X ? x[i] : min.X;
+            min.Y = y[i] < min.Y ? y[i] : min.Y;
+            max.X = x[i] > max.X ? x[i] : max.X;
+            max.Y = y[i] > max.Y ? y[i] : max.Y;
+        }
+        Bounds = CRectangle(min, max);
+
+        // Shoelace formula for the area and the centroid
+        float doubleArea = 0.0f;
+        float centroidX = 0.0f;
+        float centroidY = 0.0f;
+        for (int i = 0; i < n; ++i) {
+            int next = i + 1 == n ? 0 : i + 1;
+            float cross = x[i] * y[next] - x[next] * y[i];
+            doubleArea += cross;
+            centroidX += (x[i] + x[next]) * cross;
+            centroidY += (y[i] + y[next]) * cross;
         }
 
-        return false;
-    }
+        if (doubleArea != 0.0f) {
+            Centroid = SVector_2D(centroidX / (3.0f * doubleArea), centroidY / (3.0f * doubleArea));
+        } else {
+            // degenerate polygon, fall back to the average of the vertices
+            SVector_2D sum;
+            for (int i = 0; i < n; ++i) {
+                sum += SVector_2D(x[i], y[i]);
+            }
+            Centroid = sum * (1.0f / float(n));
+        }
 
-    bool DoRectanglesOverlap_Y(const CRectangle& R1, const CRectangle& R2) {
-        if ((R1.TopLeft.Y < R2.BottomRight.Y  ) &&
-        (R1.BottomRight.Y > R2.TopLeft.Y  ) ) {
-            return true;
+        // Outward normals: the edge rotated away from the interior, which
+        // side that is depends on the winding
+        float side = doubleArea < 0.0f ? -1.0f : 1.0f;
+        bool positive = false;
+        bool negative = false;
+        for (int i = 0; i < n; ++i) {
+            int next = i + 1 == n ? 0 : i + 1;
+            int afterNext = next + 1 == n ? 0 : next + 1;
+
+            SVector_2D normal(side * (y[next] - y[i]), side * (x[i] - x[next]));
+            float length = normal.Magnitude();
+            if (length > 0.0f) normal /= length;
+            normalX[i] = normal.X;
+            normalY[i] = normal.Y;
+
+            float turn = (x[next] - x[i]) * (y[afterNext] - y[next]) -
+                         (y[next] - y[i]) * (x[afterNext] - x[next]);
+            positive = positive || turn > 0.0f;
+            negative = negative || turn < 0.0f;
         }
-        return false;
+        // a flat polygon has no usable normals, keep it off the convex paths
+        Convex = !(positive && negative) && doubleArea != 0.0f;
     }
 
-    CRectangle CreateRectangleIncludingTwoPoints(const SVector_2D& Point1, const SVector_2D& Point2) {
-        SVector_2D TL;
-        TL.X = Point1.X < Point2.X ? Point1.X : Point2.X;
-        TL.Y = Point1.Y < Point2.Y ? Point1.Y: Point2.Y;
 
-        SVector_2D BR;
-        BR.X = Point1.X < Point2.X ? Point2.X : Point1.X;
-        BR.Y = Point1.Y < Point2.Y ? Point2.Y: Point1.Y;
+    bool IsPointInsidePolygon(const SVector_2D& Point, const CPolygon& Polygon) {
+        int n = Polygon.GetVertexCount();
+        if (n == 0 || !IsPointInsideRect(Point, Polygon.GetBounds())) return false;
 
+        const float* x = Polygon.GetX();
+        const float* y = Polygon.GetY();
 
-        return CRectangle(TL, BR);
-    }
+        if (Polygon.IsConvex()) {
+            // behind every edge
+            const float* normalX = Polygon.GetNormalX();
+            const float* normalY = Polygon.GetNormalY();
+            float maxDistance = std::numeric_limits<float>::lowest();
+            for (int i = 0; i < n; ++i) {
+                float distance = (Point.X - x[i]) * normalX[i] + (Point.Y - y[i]) * normalY[i];
+                maxDistance = distance > maxDistance ? distance : maxDistance;
+            }
+            return maxDistance <= 0.0f;
+        }
 
-    // ===== RECTANGLE =====
+        // Crossing number, points on an edge count as inside
+        bool inside = false;
+        for (int i = 0, j = n - 1; i < n; j = i++) {
+            float edgeX = x[i] - x[j];
+            float edgeY = y[i] - y[j];
+            float cross = edgeX * (Point.Y - y[j]) - edgeY * (Point.X - x[j]);
+            if (cross == 0.0f &&
+                (Point.X - x[i]) * (Point.X - x[j]) <= 0.0f &&
+                (Point.Y - y[i]) * (Point.Y - y[j]) <= 0.0f) return true;
+
+            if ((y[i] > Point.Y) != (y[j] > Point.Y) &&
+                Point.X < x[j] + edgeX * (Point.Y - y[j]) / edgeY) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    // Projects the polygon on an axis
+    static void ProjectPolygon(const CPolygon& Polygon, float AxisX, float AxisY, float& Min, float& Max) {
+        const float* x = Polygon.GetX();
+        const float* y = Polygon.GetY();
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        for (int i = 0, n = Polygon.GetVertexCount(); i < n; ++i) {
+            float projection = x[i] * AxisX + y[i] * AxisY;
+            min = projection < min ? projection : min;
+            max = projection > max ? projection : max;
+        }
+        Min = min;
+        Max = max;
+    }
+
+    // Separating axis theorem: convex polygons don't overlap if the projections
+    // on one of the edge normals are disjoint
+    static bool HasSeparatingAxis(const CPolygon& Polygon1, const CPolygon& Polygon2) {
+        const float* normalX = Polygon1.GetNormalX();
+        const float* normalY = Polygon1.GetNormalY();
+        for (int i = 0, n = Polygon1.GetVertexCount(); i < n; ++i) {
+            float min1, max1, min2, max2;
+            ProjectPolygon(Polygon1, normalX[i], normalY[i], min1, max1);
+            ProjectPolygon(Polygon2, normalX[i], normalY[i], min2, max2);
+            if (max1 < min2 || max2 < min1) return true;
+        }
+        return false;
+    }
 
+    static bool DoSegmentsIntersect(const SVector_2D& A, const SVector_2D& B,
+                                    const SVector_2D& C, const SVector_2D& D) {
+        float d1 = (D.X - C.X) * (A.Y - C.Y) - (D.Y - C.Y) * (A.X - C.X);
+        float d2 = (D.X - C.X) * (B.Y - C.Y) - (D.Y - C.Y) * (B.X - C.X);
+        float d3 = (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+        float d4 = (B.X - A.X) * (D.Y - A.Y) - (B.Y - A.Y) * (D.X - A.X);
 
+        if (((d1 > 0.0f && d2 < 0.0f) || (d1 < 0.0f && d2 > 0.0f)) &&
+            ((d3 > 0.0f && d4 < 0.0f) || (d3 < 0.0f && d4 > 0.0f))) return true;
 
-    // ===== Circle =====
-    float CCircle::GetRadius() const {
-        return Radius;
+        // collinear cases: an end point lies on the other segment
+        CRectangle ab = CreateRectangleIncludingTwoPoints(A, B);
+        CRectangle cd = CreateRectangleIncludingTwoPoints(C, D);
+        return (d1 == 0.0f && IsPointInsideRect(A, cd)) ||
+               (d2 == 0.0f && IsPointInsideRect(B, cd)) ||
+               (d3 == 0.0f && IsPointInsideRect(C, ab)) ||
+               (d4 == 0.0f && IsPointInsideRect(D, ab));
     }
 
-    SVector_2D CCircle::GetCenter() const {
-        return Center;
-    }
-    // ===== Circle =====
-}
+    bool DoPolygonsOverlap(const CPolygon& Polygon1, const CPolygon& Polygon2) {
+        int n1 = Polygon1.GetVertexCount();
+        int n2 = Polygon2.GetVertexCount();
+        if (n1 == 0 || n2 == 0) return false;
 
-namespace Math {
-    float RadiansToDegrees(float Rad) {
-        return Rad * (180 / PI);
-    }
+        const CRectangle& bounds1 = Polygon1.GetBounds();
+        const CRectangle& bounds2 = Polygon2.GetBounds();
+        if (bounds1.TopLeft.X > bounds2.BottomRight.X || bounds2.TopLeft.X > bounds1.BottomRight.X ||
+            bounds1.TopLeft.Y > bounds2.BottomRight.Y || bounds2.TopLeft.Y > bounds1.BottomRight.Y) return false;
 
-    float DegreesToRadians(float Deg) {
-        return Deg / (180 * PI);
-    }
+        if (Polygon1.IsConvex() && Polygon2.IsConvex()) {
+            return !HasSeparatingAxis(Polygon1, Polygon2) && !HasSeparatingAxis(Polygon2, Polygon1);
+        }
 
-    float Lerp(float a, float b, float f) {
-        if (f < 0.0f || f > 1.0f) return 0.0f;
+        for (int i = 0; i < n1; ++i) {
+            SVector_2D a = Polygon1.GetVertex(i);
+            SVector_2D b = Polygon1.GetVertex(i + 1 == n1 ? 0 : i + 1);
+            for (int j = 0; j < n2; ++j) {
+                if (DoSegmentsIntersect(a, b, Polygon2.GetVertex(j), Polygon2.GetVertex(j + 1 == n2 ? 0 : j + 1))) {
+                    return true;
+                }
+            }
+        }
 
-        return (1 - f) * a + f * b;
+        // no crossing edges: either one contains the other or they are apart
+        return IsPointInsidePolygon(Polygon1.GetVertex(0), Polygon2) ||
+               IsPointInsidePolygon(Polygon2.GetVertex(0), Polygon1);
     }
+    // ===== BASE POLYGON =====
 
-    bool IsNearlyEqual(double a, double b, double epsilon){
-        return fabs(a - b) <= ( (fabs(a) < fabs(b) ? fabs(b) : fabs(a)) * epsilon);
-    }
 
 
+    // ===== Triangle =====
+    CTriangle::CTriangle(const SVector_2D& A, const SVector_2D& B, const SVector_2D& C) : CPolygon() {
+        SVector_2D vertices[] = {A, B, C};
+        SetVertices(vertices, 3);
+    }
+    // ===== Triangle =====
+}
+
+namespace Math {
     // MATRICES
 
     // CONSTRUCTORS/DESTRUCTOR
     template<typename T>
     Matrix<T>::Matrix() :
             N(0),
-            M(0) {}
+            M(0),
+            array(nullptr) {}
 
     template<typename T>
     Matrix<T>::Matrix(int N, int M) : N(N), M(M), array(nullptr) {
@@ -232,8 +343,6 @@ namespace Math {
 
         // delete columns
         delete[] array;
-
-        std::cout << "deleted\n";
     }
 
     template<typename T>
@@ -362,5 +471,7 @@ namespace Math {
 
 
     template class Matrix<int>;
+    template class Matrix<float>;
+    template class Matrix<double>;
 
 }
@@ -9,83 +9,104 @@
 
 namespace Geometry_2D {
     // ===== VECTOR 2D =====
+    // The arithmetic is constexpr and lives in this header, so it can build
+    // constants at compile time and inlines into callers outside the library.
     struct SVector_2D;
-    bool operator==(const SVector_2D& Vector1, const SVector_2D& Vector2);
+    constexpr bool operator==(const SVector_2D& Vector1, const SVector_2D& Vector2);
 
     struct SVector_2D {
         float X, Y;
 
-        explicit SVector_2D(float DefaultValue = 0.0f);
-        SVector_2D(float x, float y);
-        SVector_2D(const SVector_2D& Vector_2D);
+        constexpr explicit SVector_2D(float DefaultValue = 0.0f) : X(DefaultValue), Y(DefaultValue) {}
+        constexpr SVector_2D(float x, float y) : X(x), Y(y) {}
+        constexpr SVector_2D(const SVector_2D& Vector_2D) = default;
 
         float Magnitude() const;
 
         void Normalize();
 
         // OPERATORS
-        SVector_2D& operator=(const SVector_2D& Vector2);
-
-        SVector_2D& operator+=(const SVector_2D& Vector2);
-        SVector_2D& operator-=(const SVector_2D& Vector2);
-        SVector_2D& operator*=(float Value);
-        SVector_2D& operator/=(float Value);
-
-        bool operator() (const SVector_2D& Vector1, const SVector_2D& Vector2) const;
+        constexpr SVector_2D& operator=(const SVector_2D& Vector2) = default;
+
+        constexpr SVector_2D& operator+=(const SVector_2D& Vector2) {
+            X += Vector2.X;
+            Y += Vector2.Y;
+            return *this;
+        }
+        constexpr SVector_2D& operator-=(const SVector_2D& Vector2) {
+            X -= Vector2.X;
+            Y -= Vector2.Y;
+            return *this;
+        }
+        constexpr SVector_2D& operator*=(float Value) {
+            X *= Value;
+            Y *= Value;
+            return *this;
+        }
+        constexpr SVector_2D& operator/=(float Value) {
+            X /= Value;
+            Y /= Value;
+            return *this;
+        }
+
+        constexpr bool operator() (const SVector_2D& Vector1, const SVector_2D& Vector2) const {
+            return Vector1 == Vector2;
+        }
     };
 
     // OPERATORS
-    SVector_2D operator+(const SVector_2D& Vector1, const SVector_2D& Vector2);
-    SVector_2D operator-(const SVector_2D& Vector1, const SVector_2D& Vector2);
+    constexpr SVector_2D operator+(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return SVector_2D(Vector1.X + Vector2.X, Vector1.Y + Vector2.Y);
+    }
+    constexpr SVector_2D operator-(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return SVector_2D(Vector1.X - Vector2.X, Vector1.Y - Vector2.Y);
+    }
 
     // Vector * Number
-    SVector_2D operator*(const SVector_2D &Vector1, float Value);
+    constexpr SVector_2D operator*(const SVector_2D &Vector1, float Value) {
+        return SVector_2D(Vector1.X * Value, Vector1.Y * Value);
+    }
     // Number * Vector
-    SVector_2D operator*(float Value, const SVector_2D &Vector1);
+    constexpr SVector_2D operator*(float Value, const SVector_2D &Vector1) {
+        return Vector1 * Value;
+    }
 
     std::ostream& operator<<(std::ostream& out, const SVector_2D& Vector);
 
-    bool operator!=(SVector_2D a, SVector_2D b);
+    constexpr bool operator==(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return Vector1.X == Vector2.X && Vector1.Y == Vector2.Y;
+    }
+
+    constexpr bool operator!=(SVector_2D a, SVector_2D b) {
+        return !(a == b);
+    }
 
-    bool operator<(SVector_2D a, SVector_2D b);
+    // X first, then Y
+    constexpr bool operator<(SVector_2D a, SVector_2D b) {
+        return a.X < b.X || (a.X == b.X && a.Y < b.Y);
+    }
 
     float AngleBetweenVectors(const SVector_2D& Vector1, const SVector_2D& Vector2);
 
-    float DotProduct(const SVector_2D& Vector1, const SVector_2D& Vector2);
+    constexpr float DotProduct(const SVector_2D& Vector1, const SVector_2D& Vector2) {
+        return Vector1.X*Vector2.X + Vector1.Y*Vector2.Y;
+    }
 
-    const SVector_2D ZeroVector_2D(0.0f, 0.0f);
+    constexpr SVector_2D ZeroVector_2D(0.0f, 0.0f);
     // ===== VECTOR 2D =====
 
 
 
-    // [POLYGONS]
-    // ===== BASE POLYGON =====
-    class CPolygon {
-        int VertexMaxQuantity;
-
-    public:
-        inline CPolygon(int VertexNumber) : VertexMaxQuantity(VertexNumber) {}
-    };
-    // ===== BASE POLYGON =====
-
-
-
-    // ===== Triangle =====
-    class CTriangle : public CPolygon {
-    public:
-    };
-    // ===== Triangle =====
-
-
     // ===== BaseFigure =====
     enum EFIGURE_TYPE {
         ERECT,
-        ECIRCLE
+        ECIRCLE,
+        EPOLYGON
     };
     class CFigure {
     public:
         EFIGURE_TYPE Type;
-        CFigure(EFIGURE_TYPE FigureType) : Type(FigureType) {}
+        constexpr CFigure(EFIGURE_TYPE FigureType) : Type(FigureType) {}
     };
 
     // ===== Circle =====
@@ -116,27 +137,115 @@ namespace Geometry_2D {
         SVector_2D TopLeft;
         SVector_2D BottomRight;
 
-        inline CRectangle(EFIGURE_TYPE Type = ERECT) : CFigure(Type),
-                                                       TopLeft(SVector_2D()),
-                                                       BottomRight(SVector_2D()) {}
-        inline CRectangle(const SVector_2D& TL,
-                          const SVector_2D& BR,
-                          EFIGURE_TYPE Type = ERECT) : CFigure(Type),
-                                                       TopLeft(TL),
-                                                       BottomRight(BR) {}
-        SVector_2D GetSize() const;
+        constexpr CRectangle(EFIGURE_TYPE Type = ERECT) : CFigure(Type),
+                                                          TopLeft(SVector_2D()),
+                                                          BottomRight(SVector_2D()) {}
+        constexpr CRectangle(const SVector_2D& TL,
+                             const SVector_2D& BR,
+                             EFIGURE_TYPE Type = ERECT) : CFigure(Type),
+                                                          TopLeft(TL),
+                                                          BottomRight(BR) {}
+        constexpr SVector_2D GetSize() const {
+            return SVector_2D(BottomRight.X - TopLeft.X,
+                              BottomRight.Y - TopLeft.Y);
+        }
     };
 
-    bool IsPointInsideRect(const SVector_2D& Point, const CRectangle& Rect);
+    constexpr bool IsPointInsideRect(const SVector_2D& Point, const CRectangle& Rect) {
+        return (Point.X >= Rect.TopLeft.X && Point.X <= Rect.BottomRight.X) &&
+               (Point.Y >= Rect.TopLeft.Y && Point.Y <= Rect.BottomRight.Y);
+    }
+
+    constexpr bool DoRectanglesOverlap_X(const CRectangle& R1, const CRectangle& R2) {
+        return R1.TopLeft.X < R2.BottomRight.X && R1.BottomRight.X > R2.TopLeft.X;
+    }
+
+    constexpr bool DoRectanglesOverlap_Y(const CRectangle& R1, const CRectangle& R2) {
+        return R1.TopLeft.Y < R2.BottomRight.Y && R1.BottomRight.Y > R2.TopLeft.Y;
+    }
+
+    constexpr bool DoRectanglesOverlap(const CRectangle& R1, const CRectangle& R2) {
+        return DoRectanglesOverlap_X(R1, R2) && DoRectanglesOverlap_Y(R1, R2);
+    }
+
+    constexpr CRectangle CreateRectangleIncludingTwoPoints(const SVector_2D& Point1, const SVector_2D& Point2) {
+        return CRectangle(SVector_2D(Point1.X < Point2.X ? Point1.X : Point2.X,
+                                     Point1.Y < Point2.Y ? Point1.Y : Point2.Y),
+                          SVector_2D(Point1.X < Point2.X ? Point2.X : Point1.X,
+                                     Point1.Y < Point2.Y ? Point2.Y : Point1.Y));
+    }
+    // ===== RECTANGLE =====
 
-    bool DoRectanglesOverlap(const CRectangle& rect1, const CRectangle& rect2);
 
-    bool DoRectanglesOverlap_X(const CRectangle& rect1, const CRectangle& rect2);
 
-    bool DoRectanglesOverlap_Y(const CRectangle& rect1, const CRectangle& rect2);
+    // [POLYGONS]
+    // ===== BASE POLYGON =====
+    // Convex or concave simple polygon. Vertices and outward edge normals are
+    // kept as separate X/Y arrays (structure of arrays) so the projection
+    // loops of the overlap tests run over contiguous floats. Up to
+    // InlineCapacity vertices live inside the object, bigger polygons
+    // allocate. Normal i belongs to the edge from vertex i to vertex i + 1.
+    class CPolygon : public CFigure {
+    public:
+        static const int InlineCapacity = 8;
 
-    CRectangle CreateRectangleIncludingTwoPoints(const SVector_2D&, const SVector_2D&);
-    // ===== RECTANGLE =====
+    private:
+        int VertexCount;
+        int Capacity;
+        // [X * Capacity][Y * Capacity][NormalX * Capacity][NormalY * Capacity]
+        float* Data;
+        float InlineData[4 * InlineCapacity];
+
+        CRectangle Bounds;
+        SVector_2D Centroid;
+        bool Convex;
+
+        void Reserve(int Count);
+        void UpdateCache();
+
+    public:
+        CPolygon(EFIGURE_TYPE Type = EPOLYGON);
+        CPolygon(const SVector_2D* Vertices, int Count, EFIGURE_TYPE Type = EPOLYGON);
+        CPolygon(const std::vector<SVector_2D>& Vertices, EFIGURE_TYPE Type = EPOLYGON);
+        CPolygon(const CPolygon& Polygon);
+        ~CPolygon();
+
+        CPolygon& operator=(const CPolygon& Polygon);
+
+        void SetVertices(const SVector_2D* Vertices, int Count);
+
+        inline int GetVertexCount() const { return VertexCount; }
+        inline SVector_2D GetVertex(int Index) const { return SVector_2D(Data[Index], Data[Capacity + Index]); }
+        inline SVector_2D GetNormal(int Index) const {
+            return SVector_2D(Data[2 * Capacity + Index], Data[3 * Capacity + Index]);
+        }
+
+        inline const float* GetX() const { return Data; }
+        inline const float* GetY() const { return Data + Capacity; }
+        inline const float* GetNormalX() const { return Data + 2 * Capacity; }
+        inline const float* GetNormalY() const { return Data + 3 * Capacity; }
+
+        inline const CRectangle& GetBounds() const { return Bounds; }
+        inline SVector_2D GetCentroid() const { return Centroid; }
+        inline bool IsConvex() const { return Convex; }
+    };
+
+    // Points on the border are inside
+    bool IsPointInsidePolygon(const SVector_2D& Point, const CPolygon& Polygon);
+
+    // Separating axis test when both polygons are convex, edge intersection
+    // and containment tests otherwise. Touching polygons overlap.
+    bool DoPolygonsOverlap(const CPolygon& Polygon1, const CPolygon& Polygon2);
+    // ===== BASE POLYGON =====
+
+
+
+    // ===== Triangle =====
+    class CTriangle : public CPolygon {
+    public:
+        CTriangle(const SVector_2D& A, const SVector_2D& B, const SVector_2D& C);
+    };
+    // ===== Triangle =====
 }
 
 namespace Math {
@@ -147,19 +256,29 @@ namespace Math {
         FOURTH,
     };
 
-    const float PI = 3.1415926;
+    constexpr float PI = 3.1415926;
 
-    float RadiansToDegrees(float Rad);
+    constexpr float RadiansToDegrees(float Rad) {
+        return Rad * (180 / PI);
+    }
 
-    float DegreesToRadians(float Deg);
+    constexpr float DegreesToRadians(float Deg) {
+        return Deg * (PI / 180);
+    }
 
     // a and b - values being interpolated between
     // f - fractional value int the range of [0, 1] from a to b
     // `Game Programming Algorithms and Techniques, Vectors, p.55`
-    float Lerp(float a, float b, float f);
+    constexpr float Lerp(float a, float b, float f) {
+        return (f < 0.0f || f > 1.0f) ? 0.0f : (1 - f) * a + f * b;
+    }
 
     // returns an approximate answer whether the two double values are equal
-    bool IsNearlyEqual(double a, double b, double epsilon);
+    constexpr bool IsNearlyEqual(double a, double b, double epsilon) {
+        // std::fabs isn't constexpr
+        return (a - b < 0 ? b - a : a - b) <=
+               ((a < 0 ? -a : a) < (b < 0 ? -b : b) ? (b < 0 ? -b : b) : (a < 0 ? -a : a)) * epsilon;
+    }
 
     // ===== MATRIX =====
     template<class T>
@@ -181,6 +300,9 @@ namespace Math {
 
         Geometry_2D::SVector_2D GetSize() const;
 
+        inline int Rows() const { return N; }
+        inline int Cols() const { return M; }
+
         Matrix<T> GetTranspose();
 
         Matrix<T> &operator=(const Matrix<T> &Matrix);
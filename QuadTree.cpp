@@ -5,6 +5,9 @@
 
 #include "QuadTree.h"
 #include <queue>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 using namespace Geometry_2D;
 
@@ -98,13 +101,14 @@ namespace Collision {
         if (IsLeaf()) {
             int removeIndex = -1;
             for (int i=0, size=contents.size(); i<size; ++i) {
-                if (contents[i]->Object == data.Object) {
+                if (contents[i]->Object == data.Object &&
+                    contents[i]->Shape == data.Shape) {
                     removeIndex = i;
                     break;
                 }
             }
             if (removeIndex != -1) {
-                contents.erase(contents.begin() + 1);
+                contents.erase(contents.begin() + removeIndex);
             }
         } else {
             for (int i=0, size=children.size(); i<size; ++i) {
@@ -200,7 +204,9 @@ namespace Collision {
         }
 
         for (int i = 0, size = contents.size(); i < size; ++i) {
-            children[i].Insert(*contents[i]);
+            for (int j = 0; j < 4; ++j) {
+                children[j].Insert(*contents[i]);
+            }
         }
 
         contents.clear();
@@ -230,4 +236,356 @@ namespace Collision {
         }
         return result;
     }
+
+
+
+    // ===== RAYS =====
+    static inline SVector_2D InverseDirection(const SVector_2D& Direction) {
+        // a zero component gives an infinite inverse, RaySlab handles it separately
+        return SVector_2D(1.0f / Direction.X, 1.0f / Direction.Y);
+    }
+
+    // Clips [TMin, TMax] to one slab. A ray parallel to the slab (infinite
+    // inverse) never crosses it, so it's inside for every t when the origin
+    // is, inclusive of the edges, and nowhere otherwise. Multiplying would
+    // give 0 * inf = NaN for an origin on the edge.
+    static inline bool RaySlab(float Origin, float InvDirection, float Min, float Max,
+                               float& TMin, float& TMax) {
+        if (std::isinf(InvDirection)) return Origin >= Min && Origin <= Max;
+
+        float t1 = (Min - Origin) * InvDirection;
+        float t2 = (Max - Origin) * InvDirection;
+        TMin = std::fmax(TMin, std::fmin(t1, t2));
+        TMax = std::fmin(TMax, std::fmax(t1, t2));
+        return true;
+    }
+
+    // Slab test, Enter is where the ray gets into the box (0 if it starts inside)
+    static inline bool RayBox(const SVector_2D& Origin, const SVector_2D& InvDirection,
+                              const CRectangle& Box, float MaxDistance, float& Enter) {
+        float tMin = 0.0f;
+        float tMax = MaxDistance;
+        if (!RaySlab(Origin.X, InvDirection.X, Box.TopLeft.X, Box.BottomRight.X, tMin, tMax) ||
+            !RaySlab(Origin.Y, InvDirection.Y, Box.TopLeft.Y, Box.BottomRight.Y, tMin, tMax)) return false;
+
+        Enter = tMin;
+        return tMin <= tMax;
+    }
+
+    static void RaycastNode(const QuadTreeNode& Node, const SRay& Ray, const SVector_2D& InvDirection,
+                            bool Any, SRayHit& Hit) {
+        if (Node.IsLeaf()) {
+            for (int i = 0, size = Node.contents.size(); i < size; ++i) {
+                float enter;
+                if (RayBox(Ray.Origin, InvDirection, Node.contents[i]->bounds, Hit.Distance, enter) &&
+                    (Hit.Data == nullptr || enter < Hit.Distance)) {
+                    Hit.Data = Node.contents[i];
+                    Hit.Distance = enter;
+                    if (Any) return;
+                }
+            }
+            return;
+        }
+
+        // front to back: sort the children the ray enters by entry distance
+        int order[4];
+        float enters[4];
+        int count = 0;
+        for (int i = 0, size = Node.children.size(); i < size && i < 4; ++i) {
+            float enter;
+            if (!RayBox(Ray.Origin, InvDirection, Node.children[i].nodeBounds, Hit.Distance, enter)) continue;
+
+            int position = count++;
+            while (position > 0 && enters[position - 1] > enter) {
+                enters[position] = enters[position - 1];
+                order[position] = order[position - 1];
+                --position;
+            }
+            enters[position] = enter;
+            order[position] = i;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (Hit.Data != nullptr && (Any || enters[i] > Hit.Distance)) return;
+            RaycastNode(Node.children[order[i]], Ray, InvDirection, Any, Hit);
+        }
+    }
+
+    bool QuadTreeNode::Raycast(const SRay& Ray, SRayHit& Hit) const {
+        Hit.Data = nullptr;
+        Hit.Distance = Ray.MaxDistance;
+
+        SVector_2D invDirection = InverseDirection(Ray.Direction);
+        float enter;
+        if (!RayBox(Ray.Origin, invDirection, nodeBounds, Ray.MaxDistance, enter)) return false;
+
+        RaycastNode(*this, Ray, invDirection, false, Hit);
+        return Hit.Data != nullptr;
+    }
+
+    bool QuadTreeNode::RaycastAny(const SRay& Ray) const {
+        SRayHit hit;
+        hit.Distance = Ray.MaxDistance;
+
+        SVector_2D invDirection = InverseDirection(Ray.Direction);
+        float enter;
+        if (!RayBox(Ray.Origin, invDirection, nodeBounds, Ray.MaxDistance, enter)) return false;
+
+        RaycastNode(*this, Ray, invDirection, true, hit);
+        return hit.Data != nullptr;
+    }
+
+    // Mask has one bit per ray of the packet still worth testing in this node
+    static void RaycastPacket(const QuadTreeNode& Node, const SRay* Rays, const SVector_2D* InvDirections,
+                              uint32_t Mask, SRayHit* Hits) {
+        // drop the rays missing the node or already hitting something in front of it
+        uint32_t active = 0;
+        int first = -1;
+        for (int r = 0; r < RayPacketSize; ++r) {
+            if (!(Mask & (1u << r))) continue;
+
+            float enter;
+            if (RayBox(Rays[r].Origin, InvDirections[r], Node.nodeBounds, Hits[r].Distance, enter) &&
+                (Hits[r].Data == nullptr || enter < Hits[r].Distance)) {
+                active |= 1u << r;
+                if (first < 0) first = r;
+            }
+        }
+        if (active == 0) return;
+
+        if (Node.IsLeaf()) {
+            // objects outside, rays inside: every object is loaded once for the whole packet
+            for (int i = 0, size = Node.contents.size(); i < size; ++i) {
+                QuadTreeData* data = Node.contents[i];
+                for (int r = first; r < RayPacketSize; ++r) {
+                    if (!(active & (1u << r))) continue;
+
+                    float enter;
+                    if (RayBox(Rays[r].Origin, InvDirections[r], data->bounds, Hits[r].Distance, enter) &&
+                        (Hits[r].Data == nullptr || enter < Hits[r].Distance)) {
+                        Hits[r].Data = data;
+                        Hits[r].Distance = enter;
+                    }
+                }
+            }
+            return;
+        }
+
+        // the first active ray decides the order, rays of a packet usually point the same way
+        int order[4];
+        float enters[4];
+        int count = 0;
+        for (int i = 0, size = Node.children.size(); i < size && i < 4; ++i) {
+            float enter;
+            if (!RayBox(Rays[first].Origin, InvDirections[first], Node.children[i].nodeBounds,
+                        std::numeric_limits<float>::max(), enter)) {
+                enter = std::numeric_limits<float>::max();
+            }
+
+            int position = count++;
+            while (position > 0 && enters[position - 1] > enter) {
+                enters[position] = enters[position - 1];
+                order[position] = order[position - 1];
+                --position;
+            }
+            enters[position] = enter;
+            order[position] = i;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            RaycastPacket(Node.children[order[i]], Rays, InvDirections, active, Hits);
+        }
+    }
+
+    void QuadTreeNode::RaycastBatch(const SRay* Rays, int Count, SRayHit* Hits) const {
+        SVector_2D invDirections[RayPacketSize];
+
+        for (int start = 0; start < Count; start += RayPacketSize) {
+            int size = Count - start < RayPacketSize ? Count - start : RayPacketSize;
+            uint32_t mask = 0;
+            for (int r = 0; r < size; ++r) {
+                invDirections[r] = InverseDirection(Rays[start + r].Direction);
+                Hits[start + r].Data = nullptr;
+                Hits[start + r].Distance = Rays[start + r].MaxDistance;
+                mask |= 1u << r;
+            }
+
+            RaycastPacket(*this, Rays + start, invDirections, mask, Hits + start);
+        }
+    }
+    // ===== RAYS =====
+
+
+
+    // ===== NEAREST =====
+    static inline float DistanceSquaredToBox(const SVector_2D& Point, const CRectangle& Box) {
+        float dx = std::fmax(std::fmax(Box.TopLeft.X - Point.X, Point.X - Box.BottomRight.X), 0.0f);
+        float dy = std::fmax(std::fmax(Box.TopLeft.Y - Point.Y, Point.Y - Box.BottomRight.Y), 0.0f);
+        return dx * dx + dy * dy;
+    }
+
+    // Bounded, sorted candidate list living in the caller's arrays
+    struct SNearestList {
+        QuadTreeData** Results;
+        float* Distances; // squared while searching
+        int K;
+        int Count;
+
+        inline float Worst() const {
+            return Count < K ? std::numeric_limits<float>::max() : Distances[Count - 1];
+        }
+
+        inline void Offer(QuadTreeData* Data, float Distance) {
+            if (Distance >= Worst()) return;
+            // objects spanning several leaves show up more than once
+            for (int i = 0; i < Count; ++i) {
+                if (Results[i] == Data) return;
+            }
+
+            int position = Count < K ? Count++ : K - 1;
+            while (position > 0 && Distances[position - 1] > Distance) {
+                Distances[position] = Distances[position - 1];
+                Results[position] = Results[position - 1];
+                --position;
+            }
+            Distances[position] = Distance;
+            Results[position] = Data;
+        }
+    };
+
+    static void NearestNode(const QuadTreeNode& Node, const SVector_2D& Point, SNearestList& List) {
+        if (Node.IsLeaf()) {
+            for (int i = 0, size = Node.contents.size(); i < size; ++i) {
+                List.Offer(Node.contents[i], DistanceSquaredToBox(Point, Node.contents[i]->bounds));
+            }
+            return;
+        }
+
+        // closest child first so the list fills up with good candidates early
+        int order[4];
+        float distances[4];
+        int count = 0;
+        for (int i = 0, size = Node.children.size(); i < size && i < 4; ++i) {
+            float distance = DistanceSquaredToBox(Point, Node.children[i].nodeBounds);
+
+            int position = count++;
+            while (position > 0 && distances[position - 1] > distance) {
+                distances[position] = distances[position - 1];
+                order[position] = order[position - 1];
+                --position;
+            }
+            distances[position] = distance;
+            order[position] = i;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (distances[i] >= List.Worst()) return;
+            NearestNode(Node.children[order[i]], Point, List);
+        }
+    }
+
+    int QuadTreeNode::QueryNearest(const SVector_2D& Point, int K,
+                                   QuadTreeData** Results, float* Distances) const {
+        if (K <= 0) return 0;
+
+        SNearestList list = {Results, Distances, K, 0};
+        NearestNode(*this, Point, list);
+
+        for (int i = 0; i < list.Count; ++i) {
+            Distances[i] = std::sqrt(Distances[i]);
+        }
+        return list.Count;
+    }
+
+    // Mask has one bit per point of the packet whose list can still improve in this node
+    static void NearestPacket(const QuadTreeNode& Node, const SVector_2D* Points,
+                              uint32_t Mask, SNearestList* Lists) {
+        // drop the points already holding K candidates closer than the node
+        uint32_t active = 0;
+        int first = -1;
+        for (int p = 0; p < NearestPacketSize; ++p) {
+            if (!(Mask & (1u << p))) continue;
+
+            if (DistanceSquaredToBox(Points[p], Node.nodeBounds) < Lists[p].Worst()) {
+                active |= 1u << p;
+                if (first < 0) first = p;
+            }
+        }
+        if (active == 0) return;
+
+        if (Node.IsLeaf()) {
+            // objects outside, points inside: every object is loaded once for the whole packet
+            for (int i = 0, size = Node.contents.size(); i < size; ++i) {
+                QuadTreeData* data = Node.contents[i];
+                for (int p = first; p < NearestPacketSize; ++p) {
+                    if (!(active & (1u << p))) continue;
+                    Lists[p].Offer(data, DistanceSquaredToBox(Points[p], data->bounds));
+                }
+            }
+            return;
+        }
+
+        // the first active point decides the order, points of a packet are usually close together
+        int order[4];
+        float distances[4];
+        int count = 0;
+        for (int i = 0, size = Node.children.size(); i < size && i < 4; ++i) {
+            float distance = DistanceSquaredToBox(Points[first], Node.children[i].nodeBounds);
+
+            int position = count++;
+            while (position > 0 && distances[position - 1] > distance) {
+                distances[position] = distances[position - 1];
+                order[position] = order[position - 1];
+                --position;
+            }
+            distances[position] = distance;
+            order[position] = i;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            NearestPacket(Node.children[order[i]], Points, active, Lists);
+        }
+    }
+
+    void QuadTreeNode::QueryNearestBatch(const SVector_2D* Points, int Count, int K,
+                                         QuadTreeData** Results, float* Distances, int* Found) const {
+        if (K <= 0) {
+            for (int i = 0; i < Count; ++i) Found[i] = 0;
+            return;
+        }
+
+        SNearestList lists[NearestPacketSize];
+
+        for (int start = 0; start < Count; start += NearestPacketSize) {
+            int size = Count - start < NearestPacketSize ? Count - start : NearestPacketSize;
+            uint32_t mask = 0;
+            for (int p = 0; p < size; ++p) {
+                size_t offset = size_t(start + p) * K;
+                lists[p].Results = Results + offset;
+                lists[p].Distances = Distances + offset;
+                lists[p].K = K;
+                lists[p].Count = 0;
+                mask |= 1u << p;
+            }
+
+            NearestPacket(*this, Points + start, mask, lists);
+
+            for (int p = 0; p < size; ++p) {
+                for (int i = 0; i < lists[p].Count; ++i) {
+                    lists[p].Distances[i] = std::sqrt(lists[p].Distances[i]);
+                }
+                Found[start + p] = lists[p].Count;
+            }
+        }
+    }
+    // ===== NEAREST =====
+
+    void TransformBounds(const STransform_2D& Transform,
+                         const CRectangle* LocalBounds,
+                         QuadTreeData* const* Data,
+                         size_t Count) {
+        for (size_t i = 0; i < Count; ++i) {
+            Geometry_2D::TransformBounds(Transform, LocalBounds[i], Data[i]->bounds);
+        }
+    }
 }
\ No newline at end of file
@@ -6,7 +6,10 @@
 #ifndef PROGRAM_QUADTREE_H
 #define PROGRAM_QUADTREE_H
 
+#include <cstddef>
 #include "MATH.h"
+#include "Transform.h"
+#include "ShapeRegistry.h"
 
 namespace Collision {
     using Geometry_2D::SVector_2D;
@@ -22,14 +25,51 @@ namespace Collision {
     struct QuadTreeData {
 //        void* object;
         CFigure* Object;
+        // set instead of Object for shapes kept in a CShapeRegistry
+        SShapeHandle Shape;
         Geometry_2D::CRectangle bounds;
         bool flag;
         inline QuadTreeData(CFigure* o, const Geometry_2D::CRectangle& b) :
                 Object(o),
                 bounds(b),
                 flag(false) {}
+        inline QuadTreeData(Geometry_2D::CPolygon* Polygon) :
+                Object(Polygon),
+                bounds(Polygon->GetBounds()),
+                flag(false) {}
+        inline QuadTreeData(SShapeHandle Handle, const Geometry_2D::CRectangle& b) :
+                Object(nullptr),
+                Shape(Handle),
+                bounds(b),
+                flag(false) {}
+    };
+
+    // ===== RAYS =====
+    // Distances are measured in units of Direction, which doesn't have to be normalized
+    struct SRay {
+        SVector_2D Origin;
+        SVector_2D Direction;
+        float MaxDistance;
+        inline SRay() : Origin(0.0f), Direction(1.0f, 0.0f), MaxDistance(0.0f) {}
+        inline SRay(const SVector_2D& origin, const SVector_2D& direction, float maxDistance) :
+                Origin(origin),
+                Direction(direction),
+                MaxDistance(maxDistance) {}
+    };
+
+    struct SRayHit {
+        QuadTreeData* Data; // nullptr when nothing was hit
+        float Distance;
+        inline SRayHit() : Data(nullptr), Distance(0.0f) {}
     };
 
+    // Up to 32 rays of a batch travel through the tree together
+    const int RayPacketSize = 32;
+    // ===== RAYS =====
+
+    // Up to 32 points of a nearest neighbour batch travel through the tree together
+    const int NearestPacketSize = 32;
+
     class QuadTreeNode {
     public:
         std::vector<QuadTreeNode> children;
@@ -50,12 +90,41 @@ namespace Collision {
         void Split();
         void Reset();
         std::vector<QuadTreeData*>Query(const Geometry_2D::CRectangle& area);
+
+        // Nearest object whose bounds the ray crosses. Children are visited
+        // front to back and skipped once they start behind the current hit.
+        bool Raycast(const SRay& Ray, SRayHit& Hit) const;
+        // Stops at the first object found, for line of sight checks
+        bool RaycastAny(const SRay& Ray) const;
+        // Same results as Raycast for every ray, but a packet of rays walks
+        // the tree together so every node and object is loaded once per packet
+        void RaycastBatch(const SRay* Rays, int Count, SRayHit* Hits) const;
+
+        // Up to K objects closest to Point (distance to their bounds, 0 when
+        // inside), nearest first. Results and Distances need room for K
+        // entries. Nodes further than the K-th candidate are pruned.
+        // Returns the number of objects found.
+        int QueryNearest(const SVector_2D& Point, int K,
+                         QuadTreeData** Results, float* Distances) const;
+        // Same results as QueryNearest for every point, but a packet of points
+        // walks the tree together so every node and object is loaded once per
+        // packet. Each point still prunes against its own K-th candidate.
+        // Results and Distances hold K entries per point, Found one per point
+        void QueryNearestBatch(const SVector_2D* Points, int Count, int K,
+                               QuadTreeData** Results, float* Distances, int* Found) const;
     };
     typedef QuadTreeNode QuadTree;
 
+    // Moves the local bounds of every object by Transform and writes the
+    // result to Data[i]->bounds, ready for QuadTreeNode::Update
+    void TransformBounds(const Geometry_2D::STransform_2D& Transform,
+                         const CRectangle* LocalBounds,
+                         QuadTreeData* const* Data,
+                         size_t Count);
+
 
     // AABB
-    bool AABB(const CRectangle& Rect1, const CRectangle& Rect2) {
+    inline bool AABB(const CRectangle& Rect1, const CRectangle& Rect2) {
         float x1 = Rect1.TopLeft.X;
         float y1 = Rect1.TopLeft.Y;
         float w1 = Rect1.GetSize().X;
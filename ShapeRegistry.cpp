@@ -0,0 +1,262 @@
+/* Shape registry:
+ * Contiguous storage per shape kind with stable handles
+ * Narrow phase dispatch over batches of same kind pairs
+ * */
+
+#include "ShapeRegistry.h"
+#include <utility>
+
+using namespace Geometry_2D;
+
+namespace Collision {
+    // ===== REGISTRY =====
+    SShapeHandle CShapeRegistry::AllocateSlot(EFIGURE_TYPE Type, uint32_t Dense) {
+        uint32_t slot;
+        if (!FreeSlots.empty()) {
+            slot = FreeSlots.back();
+            FreeSlots.pop_back();
+        } else {
+            slot = uint32_t(Slots.size());
+            Slots.push_back(SSlot{Type, 0, 0, false});
+        }
+
+        SSlot& entry = Slots[slot];
+        entry.Type = Type;
+        entry.Dense = Dense;
+        entry.Used = true;
+        Owners[Type].push_back(slot);
+        return SShapeHandle(slot, entry.Generation);
+    }
+
+    SShapeHandle CShapeRegistry::Add(const CRectangle& Rectangle) {
+        Rectangles.push_back(Rectangle);
+        return AllocateSlot(ERECT, uint32_t(Rectangles.size() - 1));
+    }
+
+    SShapeHandle CShapeRegistry::Add(const CCircle& Circle) {
+        Circles.push_back(Circle);
+        return AllocateSlot(ECIRCLE, uint32_t(Circles.size() - 1));
+    }
+
+    SShapeHandle CShapeRegistry::Add(const CPolygon& Polygon) {
+        Polygons.push_back(Polygon);
+        return AllocateSlot(EPOLYGON, uint32_t(Polygons.size() - 1));
+    }
+
+    // Moves the last shape into the hole, returns the slot of the moved shape
+    template<class T>
+    static uint32_t RemoveDense(std::vector<T>& Shapes, std::vector<uint32_t>& Owners, uint32_t Dense) {
+        uint32_t last = uint32_t(Shapes.size() - 1);
+        uint32_t moved = 0xFFFFFFFF;
+        if (Dense != last) {
+            Shapes[Dense] = Shapes[last];
+            Owners[Dense] = Owners[last];
+            moved = Owners[Dense];
+        }
+        Shapes.pop_back();
+        Owners.pop_back();
+        return moved;
+    }
+
+    bool CShapeRegistry::Remove(SShapeHandle Handle) {
+        if (!IsValid(Handle)) return false;
+
+        SSlot& entry = Slots[Handle.Slot];
+        uint32_t moved = 0xFFFFFFFF;
+        switch (entry.Type) {
+            case ERECT:
+                moved = RemoveDense(Rectangles, Owners[ERECT], entry.Dense);
+                break;
+            case ECIRCLE:
+                moved = RemoveDense(Circles, Owners[ECIRCLE], entry.Dense);
+                break;
+            case EPOLYGON:
+                moved = RemoveDense(Polygons, Owners[EPOLYGON], entry.Dense);
+                break;
+        }
+        if (moved != 0xFFFFFFFF) {
+            Slots[moved].Dense = entry.Dense;
+        }
+
+        entry.Used = false;
+        entry.Generation += 1;
+        FreeSlots.push_back(Handle.Slot);
+        return true;
+    }
+
+    bool CShapeRegistry::IsValid(SShapeHandle Handle) const {
+        return Handle.Slot < Slots.size() &&
+               Slots[Handle.Slot].Used &&
+               Slots[Handle.Slot].Generation == Handle.Generation;
+    }
+
+    CRectangle CShapeRegistry::GetBounds(SShapeHandle Handle) const {
+        switch (GetType(Handle)) {
+            case ERECT:
+                return GetRectangle(Handle);
+            case ECIRCLE: {
+                const CCircle& circle = GetCircle(Handle);
+                SVector_2D extent(circle.GetRadius());
+                return CRectangle(circle.GetCenter() - extent, circle.GetCenter() + extent);
+            }
+            case EPOLYGON:
+                return GetPolygon(Handle).GetBounds();
+        }
+        return CRectangle();
+    }
+    // ===== REGISTRY =====
+
+
+
+    // ===== PAIR KERNELS =====
+    static inline float Clamp(float Value, float Min, float Max) {
+        return Value < Min ? Min : (Value > Max ? Max : Value);
+    }
+
+    static inline float DistanceSquaredToSegment(const SVector_2D& Point, const SVector_2D& A, const SVector_2D& B) {
+        SVector_2D edge = B - A;
+        float lengthSquared = DotProduct(edge, edge);
+        float t = lengthSquared > 0.0f ? Clamp(DotProduct(Point - A, edge) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+        SVector_2D offset = Point - (A + edge * t);
+        return DotProduct(offset, offset);
+    }
+
+    static inline bool RectangleRectangleTest(const CRectangle& Rect1, const CRectangle& Rect2) {
+        return Rect2.TopLeft.X <= Rect1.BottomRight.X && Rect1.TopLeft.X <= Rect2.BottomRight.X &&
+               Rect2.TopLeft.Y <= Rect1.BottomRight.Y && Rect1.TopLeft.Y <= Rect2.BottomRight.Y;
+    }
+
+    static inline bool RectangleCircleTest(const CRectangle& Rect, const CCircle& Circle) {
+        SVector_2D center = Circle.GetCenter();
+        float dx = center.X - Clamp(center.X, Rect.TopLeft.X, Rect.BottomRight.X);
+        float dy = center.Y - Clamp(center.Y, Rect.TopLeft.Y, Rect.BottomRight.Y);
+        return dx * dx + dy * dy <= Circle.GetRadius() * Circle.GetRadius();
+    }
+
+    static inline bool RectanglePolygonTest(const CRectangle& Rect, const CPolygon& Polygon) {
+        if (!RectangleRectangleTest(Rect, Polygon.GetBounds())) return false;
+
+        SVector_2D corners[] = {
+                Rect.TopLeft,
+                SVector_2D(Rect.BottomRight.X, Rect.TopLeft.Y),
+                Rect.BottomRight,
+                SVector_2D(Rect.TopLeft.X, Rect.BottomRight.Y)
+        };
+        // 4 vertices fit in the inline storage, no allocation
+        return DoPolygonsOverlap(CPolygon(corners, 4), Polygon);
+    }
+
+    static inline bool CircleCircleTest(const CCircle& Circle1, const CCircle& Circle2) {
+        SVector_2D offset = Circle1.GetCenter() - Circle2.GetCenter();
+        float radius = Circle1.GetRadius() + Circle2.GetRadius();
+        return DotProduct(offset, offset) <= radius * radius;
+    }
+
+    static inline bool CirclePolygonTest(const CCircle& Circle, const CPolygon& Polygon) {
+        if (!RectangleCircleTest(Polygon.GetBounds(), Circle)) return false;
+
+        SVector_2D center = Circle.GetCenter();
+        if (IsPointInsidePolygon(center, Polygon)) return true;
+
+        float radiusSquared = Circle.GetRadius() * Circle.GetRadius();
+        for (int i = 0, n = Polygon.GetVertexCount(); i < n; ++i) {
+            SVector_2D a = Polygon.GetVertex(i);
+            SVector_2D b = Polygon.GetVertex(i + 1 == n ? 0 : i + 1);
+            if (DistanceSquaredToSegment(center, a, b) <= radiusSquared) return true;
+        }
+        return false;
+    }
+
+    static inline bool PolygonPolygonTest(const CPolygon& Polygon1, const CPolygon& Polygon2) {
+        return DoPolygonsOverlap(Polygon1, Polygon2);
+    }
+
+    // One homogeneous batch: both shape arrays are known up front
+    template<class A, class B, bool (*Test)(const A&, const B&), class Pair>
+    static void RunKernel(const std::vector<A>& ShapesA, const std::vector<B>& ShapesB,
+                          const Pair* Pairs, size_t Count,
+                          std::vector<SShapePair>& Overlapping) {
+        for (size_t i = 0; i < Count; ++i) {
+            if (Test(ShapesA[Pairs[i].DenseA], ShapesB[Pairs[i].DenseB])) {
+                Overlapping.push_back(Pairs[i].Pair);
+            }
+        }
+    }
+    // ===== PAIR KERNELS =====
+
+
+
+    // ===== PAIR DISPATCH =====
+    void CPairDispatcher::Dispatch(const CShapeRegistry& Registry,
+                                   const std::vector<SShapePair>& Candidates,
+                                   std::vector<SShapePair>& Overlapping) {
+        const int keyCount = FigureTypeCount * FigureTypeCount;
+
+        Resolved.clear();
+        Keys.clear();
+        Resolved.reserve(Candidates.size());
+        Keys.reserve(Candidates.size());
+
+        size_t bucketSizes[keyCount] = {};
+        for (size_t i = 0, size = Candidates.size(); i < size; ++i) {
+            SShapePair pair = Candidates[i];
+            if (!Registry.IsValid(pair.A) || !Registry.IsValid(pair.B)) continue;
+
+            int typeA = Registry.GetType(pair.A);
+            int typeB = Registry.GetType(pair.B);
+            if (typeA > typeB) {
+                std::swap(pair.A, pair.B);
+                std::swap(typeA, typeB);
+            }
+
+            SResolvedPair resolved;
+            resolved.DenseA = Registry.GetDenseIndex(pair.A);
+            resolved.DenseB = Registry.GetDenseIndex(pair.B);
+            resolved.Pair = pair;
+            Resolved.push_back(resolved);
+
+            uint8_t key = uint8_t(typeA * FigureTypeCount + typeB);
+            Keys.push_back(key);
+            bucketSizes[key] += 1;
+        }
+
+        // Counting sort by type combination
+        size_t bucketStarts[keyCount + 1];
+        bucketStarts[0] = 0;
+        for (int key = 0; key < keyCount; ++key) {
+            bucketStarts[key + 1] = bucketStarts[key] + bucketSizes[key];
+        }
+
+        Sorted.resize(Resolved.size());
+        size_t cursor[keyCount];
+        for (int key = 0; key < keyCount; ++key) {
+            cursor[key] = bucketStarts[key];
+        }
+        for (size_t i = 0, size = Resolved.size(); i < size; ++i) {
+            Sorted[cursor[Keys[i]]++] = Resolved[i];
+        }
+
+        const SResolvedPair* pairs = Sorted.data();
+        const std::vector<CRectangle>& rectangles = Registry.GetRectangles();
+        const std::vector<CCircle>& circles = Registry.GetCircles();
+        const std::vector<CPolygon>& polygons = Registry.GetPolygons();
+
+        // One kernel per type combination, A holding the lower type
+        auto bucket = [&](int TypeA, int TypeB) { return pairs + bucketStarts[TypeA * FigureTypeCount + TypeB]; };
+        auto count = [&](int TypeA, int TypeB) { return bucketSizes[TypeA * FigureTypeCount + TypeB]; };
+
+        RunKernel<CRectangle, CRectangle, RectangleRectangleTest>(
+                rectangles, rectangles, bucket(ERECT, ERECT), count(ERECT, ERECT), Overlapping);
+        RunKernel<CRectangle, CCircle, RectangleCircleTest>(
+                rectangles, circles, bucket(ERECT, ECIRCLE), count(ERECT, ECIRCLE), Overlapping);
+        RunKernel<CRectangle, CPolygon, RectanglePolygonTest>(
+                rectangles, polygons, bucket(ERECT, EPOLYGON), count(ERECT, EPOLYGON), Overlapping);
+        RunKernel<CCircle, CCircle, CircleCircleTest>(
+                circles, circles, bucket(ECIRCLE, ECIRCLE), count(ECIRCLE, ECIRCLE), Overlapping);
+        RunKernel<CCircle, CPolygon, CirclePolygonTest>(
+                circles, polygons, bucket(ECIRCLE, EPOLYGON), count(ECIRCLE, EPOLYGON), Overlapping);
+        RunKernel<CPolygon, CPolygon, PolygonPolygonTest>(
+                polygons, polygons, bucket(EPOLYGON, EPOLYGON), count(EPOLYGON, EPOLYGON), Overlapping);
+    }
+    // ===== PAIR DISPATCH =====
+}
@@ -0,0 +1,133 @@
+/* Shape registry:
+ * Contiguous storage per shape kind with stable handles
+ * Narrow phase dispatch over batches of same kind pairs
+ * */
+
+#ifndef MATH_SHAPEREGISTRY_H
+#define MATH_SHAPEREGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MATH.h"
+
+namespace Collision {
+    using Geometry_2D::EFIGURE_TYPE;
+    using Geometry_2D::CRectangle;
+    using Geometry_2D::CCircle;
+    using Geometry_2D::CPolygon;
+
+    // ERECT, ECIRCLE, EPOLYGON
+    const int FigureTypeCount = 3;
+
+    // ===== HANDLE =====
+    // Stays valid while shapes are added and removed around it. A removed
+    // shape's slot is reused with a new generation, so old handles go stale
+    // instead of pointing to another shape.
+    struct SShapeHandle {
+        uint32_t Slot;
+        uint32_t Generation;
+
+        inline SShapeHandle() : Slot(0xFFFFFFFF), Generation(0) {}
+        inline SShapeHandle(uint32_t slot, uint32_t generation) : Slot(slot), Generation(generation) {}
+    };
+
+    inline bool operator==(const SShapeHandle& a, const SShapeHandle& b) {
+        return a.Slot == b.Slot && a.Generation == b.Generation;
+    }
+
+    inline bool operator!=(const SShapeHandle& a, const SShapeHandle& b) {
+        return !(a == b);
+    }
+
+    struct SShapePair {
+        SShapeHandle A;
+        SShapeHandle B;
+    };
+    // ===== HANDLE =====
+
+
+
+    // ===== REGISTRY =====
+    // Every kind of shape lives in its own dense array, removal moves the last
+    // shape of that kind into the hole. Handles go through a slot table.
+    class CShapeRegistry {
+        struct SSlot {
+            EFIGURE_TYPE Type;
+            uint32_t Dense;
+            uint32_t Generation;
+            bool Used;
+        };
+
+        std::vector<CRectangle> Rectangles;
+        std::vector<CCircle> Circles;
+        std::vector<CPolygon> Polygons;
+        // slot of every dense entry, per kind
+        std::vector<uint32_t> Owners[FigureTypeCount];
+
+        std::vector<SSlot> Slots;
+        std::vector<uint32_t> FreeSlots;
+
+        SShapeHandle AllocateSlot(EFIGURE_TYPE Type, uint32_t Dense);
+
+    public:
+        SShapeHandle Add(const CRectangle& Rectangle);
+        SShapeHandle Add(const CCircle& Circle);
+        SShapeHandle Add(const CPolygon& Polygon);
+
+        bool Remove(SShapeHandle Handle);
+
+        bool IsValid(SShapeHandle Handle) const;
+
+        // the handle has to be valid
+        inline EFIGURE_TYPE GetType(SShapeHandle Handle) const { return Slots[Handle.Slot].Type; }
+        inline uint32_t GetDenseIndex(SShapeHandle Handle) const { return Slots[Handle.Slot].Dense; }
+
+        inline const CRectangle& GetRectangle(SShapeHandle Handle) const { return Rectangles[GetDenseIndex(Handle)]; }
+        inline const CCircle& GetCircle(SShapeHandle Handle) const { return Circles[GetDenseIndex(Handle)]; }
+        inline const CPolygon& GetPolygon(SShapeHandle Handle) const { return Polygons[GetDenseIndex(Handle)]; }
+
+        inline CRectangle& GetRectangle(SShapeHandle Handle) { return Rectangles[GetDenseIndex(Handle)]; }
+        inline CCircle& GetCircle(SShapeHandle Handle) { return Circles[GetDenseIndex(Handle)]; }
+        inline CPolygon& GetPolygon(SShapeHandle Handle) { return Polygons[GetDenseIndex(Handle)]; }
+
+        // the box to insert into a QuadTree
+        CRectangle GetBounds(SShapeHandle Handle) const;
+
+        inline const std::vector<CRectangle>& GetRectangles() const { return Rectangles; }
+        inline const std::vector<CCircle>& GetCircles() const { return Circles; }
+        inline const std::vector<CPolygon>& GetPolygons() const { return Polygons; }
+    };
+    // ===== REGISTRY =====
+
+
+
+    // ===== PAIR DISPATCH =====
+    // Narrow phase for candidate pairs (e.g. from QuadTree queries). Pairs are
+    // bucketed by type combination with a counting sort, then every bucket is
+    // run by the kernel of that combination over dense array indices, so the
+    // inner loops don't branch on the shape type. The scratch buffers are
+    // kept between calls.
+    class CPairDispatcher {
+        struct SResolvedPair {
+            uint32_t DenseA;
+            uint32_t DenseB;
+            SShapePair Pair;
+        };
+
+        std::vector<SResolvedPair> Resolved;
+        std::vector<SResolvedPair> Sorted;
+        std::vector<uint8_t> Keys;
+
+    public:
+        // Appends the overlapping pairs to Overlapping, invalid handles are
+        // skipped. Pairs come out grouped by type combination, with A holding
+        // the lower EFIGURE_TYPE.
+        void Dispatch(const CShapeRegistry& Registry,
+                      const std::vector<SShapePair>& Candidates,
+                      std::vector<SShapePair>& Overlapping);
+    };
+    // ===== PAIR DISPATCH =====
+}
+
+#endif //MATH_SHAPEREGISTRY_H
@@ -0,0 +1,450 @@
+/* Snapshots:
+ * Binary QuadTree snapshot
+ * Binary Matrix snapshot
+ * Memory mapped read-only views
+ * */
+
+#include "Snapshot.h"
+#include <algorithm>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Geometry_2D;
+
+namespace Snapshot {
+    // ===== MAPPED FILE =====
+    CMappedFile::CMappedFile() : Data(nullptr), Size(0) {}
+
+    CMappedFile::CMappedFile(const std::string& Path) : Data(nullptr), Size(0) {
+        Open(Path);
+    }
+
+    CMappedFile::CMappedFile(CMappedFile&& Other) : Data(Other.Data), Size(Other.Size) {
+        Other.Data = nullptr;
+        Other.Size = 0;
+    }
+
+    CMappedFile::~CMappedFile() {
+        Close();
+    }
+
+    bool CMappedFile::Open(const std::string& Path) {
+        Close();
+
+        int fd = open(Path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            close(fd);
+            return false;
+        }
+
+        void* memory = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        // the mapping keeps its own reference to the file
+        close(fd);
+        if (memory == MAP_FAILED) return false;
+
+        Data = static_cast<const unsigned char*>(memory);
+        Size = size_t(info.st_size);
+        return true;
+    }
+
+    void CMappedFile::Close() {
+        if (Data != nullptr) {
+            munmap(const_cast<unsigned char*>(Data), Size);
+        }
+        Data = nullptr;
+        Size = 0;
+    }
+    // ===== MAPPED FILE =====
+
+
+
+    // ===== QUADTREE =====
+    bool WriteQuadTree(const Collision::QuadTreeNode& Root,
+                       const ObjectIdFunction& GetObjectId,
+                       std::ostream& out) {
+        std::vector<SQuadTreeNode> nodes;
+        std::vector<SQuadTreeObject> objects;
+
+        // Breadth-first, so that the children of every node end up next to each other
+        std::vector<const Collision::QuadTreeNode*> order;
+        order.push_back(&Root);
+        for (size_t i = 0; i < order.size(); ++i) {
+            const Collision::QuadTreeNode* processing = order[i];
+            if (!processing->IsLeaf() && processing->children.size() != 4) return false;
+            if (processing->currentDepth < 0 || uint32_t(processing->currentDepth) >= MaxDepth) return false;
+
+            SQuadTreeNode node;
+            node.MinX = processing->nodeBounds.TopLeft.X;
+            node.MinY = processing->nodeBounds.TopLeft.Y;
+            node.MaxX = processing->nodeBounds.BottomRight.X;
+            node.MaxY = processing->nodeBounds.BottomRight.Y;
+            node.FirstChild = processing->IsLeaf() ? NoIndex : uint32_t(order.size());
+            node.FirstObject = uint32_t(objects.size());
+            node.ObjectCount = uint32_t(processing->contents.size());
+            node.Depth = uint32_t(processing->currentDepth);
+            nodes.push_back(node);
+
+            for (int j = 0, size = processing->children.size(); j < size; ++j) {
+                order.push_back(&processing->children[j]);
+            }
+
+            for (int j = 0, size = processing->contents.size(); j < size; ++j) {
+                const Collision::QuadTreeData& data = *processing->contents[j];
+
+                SQuadTreeObject object;
+                object.Id = GetObjectId(data);
+                object.MinX = data.bounds.TopLeft.X;
+                object.MinY = data.bounds.TopLeft.Y;
+                object.MaxX = data.bounds.BottomRight.X;
+                object.MaxY = data.bounds.BottomRight.Y;
+                objects.push_back(object);
+            }
+        }
+
+        if (nodes.size() >= NoIndex || objects.size() >= NoIndex) return false;
+
+        SQuadTreeHeader header;
+        header.Magic = QuadTreeMagic;
+        header.Version = FormatVersion;
+        header.NodeCount = uint32_t(nodes.size());
+        header.ObjectCount = uint32_t(objects.size());
+        header.NodesOffset = sizeof(SQuadTreeHeader);
+        header.ObjectsOffset = header.NodesOffset + nodes.size() * sizeof(SQuadTreeNode);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(SQuadTreeNode));
+        out.write(reinterpret_cast<const char*>(objects.data()), objects.size() * sizeof(SQuadTreeObject));
+        return bool(out);
+    }
+
+    bool WriteQuadTree(const Collision::QuadTreeNode& Root,
+                       const ObjectIdFunction& GetObjectId,
+                       const std::string& Path) {
+        std::ofstream out(Path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        return WriteQuadTree(Root, GetObjectId, out);
+    }
+
+
+    // Subdivides [Min, Max] exactly like QuadTreeNode::Split, Edges gets 2^Levels + 1 values
+    static void SplitAxis(float Min, float Max, int Levels, float* Edges) {
+        Edges[0] = Min;
+        Edges[1 << Levels] = Max;
+        if (Levels == 0) return;
+
+        float center = Min + ((Max - Min) * 0.5f);
+        int half = 1 << (Levels - 1);
+        SplitAxis(Min, center, Levels - 1, Edges);
+        SplitAxis(center, Max, Levels - 1, Edges + half);
+    }
+
+    // Calls Visit(NodeIndex) for every leaf overlapping the object
+    template<class Visitor>
+    static void ForEachLeaf(const std::vector<SQuadTreeNode>& Nodes,
+                            const SQuadTreeObject& Object,
+                            Visitor Visit) {
+        uint32_t stack[3 * MaxDepth + 4];
+        int top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            uint32_t index = stack[--top];
+            const SQuadTreeNode& node = Nodes[index];
+            if (!(Object.MinX <= node.MaxX && node.MinX <= Object.MaxX &&
+                  Object.MinY <= node.MaxY && node.MinY <= Object.MaxY)) continue;
+
+            if (node.FirstChild == NoIndex) {
+                Visit(index);
+            } else {
+                for (uint32_t i = 0; i < 4; ++i) {
+                    stack[top++] = node.FirstChild + 3 - i;
+                }
+            }
+        }
+    }
+
+    bool WriteQuadTree(const CRectangle& Bounds,
+                       const ObjectStreamFunction& ForEachChunk,
+                       std::ostream& out) {
+        int maxDepth = std::min(Collision::QuadTreeNode::maxDepth, StreamMaxDepth);
+        if (maxDepth < 1) maxDepth = 1;
+        int levels = maxDepth - 1;
+        int gridSize = 1 << levels;
+
+        std::vector<float> edgesX(gridSize + 1);
+        std::vector<float> edgesY(gridSize + 1);
+        SplitAxis(Bounds.TopLeft.X, Bounds.BottomRight.X, levels, edgesX.data());
+        SplitAxis(Bounds.TopLeft.Y, Bounds.BottomRight.Y, levels, edgesY.data());
+
+        // 1st pass: count the objects touching every cell of the finest level,
+        // kept as a 2D prefix sum so the load of any node is an O(1) lookup
+        int stride = gridSize + 1;
+        std::vector<uint64_t> load(size_t(stride) * stride, 0);
+        ForEachChunk([&](const SQuadTreeObject* Objects, size_t Count) {
+            for (size_t i = 0; i < Count; ++i) {
+                const SQuadTreeObject& object = Objects[i];
+                int x0 = int(std::lower_bound(edgesX.begin() + 1, edgesX.end(), object.MinX) - (edgesX.begin() + 1));
+                int x1 = int(std::upper_bound(edgesX.begin(), edgesX.end() - 1, object.MaxX) - edgesX.begin());
+                int y0 = int(std::lower_bound(edgesY.begin() + 1, edgesY.end(), object.MinY) - (edgesY.begin() + 1));
+                int y1 = int(std::upper_bound(edgesY.begin(), edgesY.end() - 1, object.MaxY) - edgesY.begin());
+                // [x0, x1) and [y0, y1) are the overlapped cells, empty outside of Bounds
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) {
+                        load[size_t(y + 1) * stride + x + 1] += 1;
+                    }
+                }
+            }
+        });
+        for (int y = 1; y <= gridSize; ++y) {
+            for (int x = 1; x <= gridSize; ++x) {
+                load[size_t(y) * stride + x] += load[size_t(y - 1) * stride + x] +
+                                                load[size_t(y) * stride + x - 1] -
+                                                load[size_t(y - 1) * stride + x - 1];
+            }
+        }
+
+        // Shape the tree breadth-first, children in QuadTreeNode::Split order
+        struct SCellBlock {
+            int X0, Y0, X1, Y1;
+            uint32_t Depth;
+        };
+        std::vector<SQuadTreeNode> nodes;
+        std::vector<SCellBlock> blocks;
+        blocks.push_back({0, 0, gridSize, gridSize, 0});
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            SCellBlock block = blocks[i];
+
+            uint64_t blockLoad = load[size_t(block.Y1) * stride + block.X1] -
+                                 load[size_t(block.Y0) * stride + block.X1] -
+                                 load[size_t(block.Y1) * stride + block.X0] +
+                                 load[size_t(block.Y0) * stride + block.X0];
+
+            SQuadTreeNode node;
+            node.MinX = edgesX[block.X0];
+            node.MinY = edgesY[block.Y0];
+            node.MaxX = edgesX[block.X1];
+            node.MaxY = edgesY[block.Y1];
+            node.FirstChild = NoIndex;
+            node.FirstObject = 0;
+            node.ObjectCount = 0;
+            node.Depth = block.Depth;
+
+            if (block.X1 - block.X0 > 1 &&
+                int(block.Depth) + 1 < maxDepth &&
+                blockLoad > uint64_t(Collision::QuadTreeNode::maxObjectsPerNode)) {
+                int midX = (block.X0 + block.X1) / 2;
+                int midY = (block.Y0 + block.Y1) / 2;
+                node.FirstChild = uint32_t(blocks.size());
+                blocks.push_back({block.X0, block.Y0, midX, midY, block.Depth + 1});
+                blocks.push_back({midX, block.Y0, block.X1, midY, block.Depth + 1});
+                blocks.push_back({midX, midY, block.X1, block.Y1, block.Depth + 1});
+                blocks.push_back({block.X0, midY, midX, block.Y1, block.Depth + 1});
+            }
+            nodes.push_back(node);
+        }
+        std::vector<uint64_t>().swap(load);
+
+        // 2nd pass: exact number of objects per leaf
+        std::vector<uint64_t> leafCounts(nodes.size(), 0);
+        ForEachChunk([&](const SQuadTreeObject* Objects, size_t Count) {
+            for (size_t i = 0; i < Count; ++i) {
+                ForEachLeaf(nodes, Objects[i], [&](uint32_t Leaf) { leafCounts[Leaf] += 1; });
+            }
+        });
+
+        uint64_t objectCount = 0;
+        std::vector<uint32_t> leafSlots(nodes.size(), NoIndex);
+        uint32_t leafNumber = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i].FirstObject = uint32_t(objectCount);
+            if (nodes[i].FirstChild == NoIndex) {
+                if (leafCounts[i] >= NoIndex || objectCount + leafCounts[i] >= NoIndex) return false;
+                nodes[i].ObjectCount = uint32_t(leafCounts[i]);
+                objectCount += leafCounts[i];
+                leafSlots[i] = leafNumber++;
+            }
+        }
+
+        SQuadTreeHeader header;
+        header.Magic = QuadTreeMagic;
+        header.Version = FormatVersion;
+        header.NodeCount = uint32_t(nodes.size());
+        header.ObjectCount = uint32_t(objectCount);
+        header.NodesOffset = sizeof(SQuadTreeHeader);
+        header.ObjectsOffset = header.NodesOffset + nodes.size() * sizeof(SQuadTreeNode);
+
+        std::streampos start = out.tellp();
+        if (start == std::streampos(-1)) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(SQuadTreeNode));
+        if (!out) return false;
+
+        // 3rd pass: every leaf gets its own small write buffer inside a fixed budget
+        size_t perLeaf = std::max<size_t>(1, StreamBufferBytes / sizeof(SQuadTreeObject) / leafNumber);
+        std::vector<SQuadTreeObject> buffers(perLeaf * leafNumber);
+        std::vector<uint32_t> buffered(leafNumber, 0);
+        std::vector<uint32_t> written(leafNumber, 0);
+        std::streamoff objectsStart = std::streamoff(start) + std::streamoff(header.ObjectsOffset);
+
+        auto flush = [&](uint32_t Leaf, uint32_t Slot) {
+            if (buffered[Slot] == 0) return;
+            out.seekp(objectsStart + std::streamoff(nodes[Leaf].FirstObject + written[Slot]) * sizeof(SQuadTreeObject));
+            out.write(reinterpret_cast<const char*>(&buffers[Slot * perLeaf]),
+                      buffered[Slot] * sizeof(SQuadTreeObject));
+            written[Slot] += buffered[Slot];
+            buffered[Slot] = 0;
+        };
+
+        bool consistent = true;
+        ForEachChunk([&](const SQuadTreeObject* Objects, size_t Count) {
+            for (size_t i = 0; i < Count; ++i) {
+                ForEachLeaf(nodes, Objects[i], [&](uint32_t Leaf) {
+                    uint32_t slot = leafSlots[Leaf];
+                    // the stream changed between passes
+                    if (written[slot] + buffered[slot] >= nodes[Leaf].ObjectCount) {
+                        consistent = false;
+                        return;
+                    }
+                    buffers[slot * perLeaf + buffered[slot]++] = Objects[i];
+                    if (buffered[slot] == perLeaf) flush(Leaf, slot);
+                });
+            }
+        });
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (leafSlots[i] == NoIndex) continue;
+            flush(uint32_t(i), leafSlots[i]);
+            if (written[leafSlots[i]] != nodes[i].ObjectCount) consistent = false;
+        }
+
+        out.seekp(objectsStart + std::streamoff(objectCount) * sizeof(SQuadTreeObject));
+        return consistent && bool(out);
+    }
+
+    bool WriteQuadTree(const CRectangle& Bounds,
+                       const ObjectStreamFunction& ForEachChunk,
+                       const std::string& Path) {
+        std::ofstream out(Path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        return WriteQuadTree(Bounds, ForEachChunk, out);
+    }
+
+
+    CQuadTreeView::CQuadTreeView() : Header(nullptr), Nodes(nullptr), Objects(nullptr) {}
+
+    CQuadTreeView::CQuadTreeView(const void* Data, size_t Size) :
+            Header(nullptr),
+            Nodes(nullptr),
+            Objects(nullptr) {
+        if (Data == nullptr || Size < sizeof(SQuadTreeHeader)) return;
+
+        const unsigned char* bytes = static_cast<const unsigned char*>(Data);
+        const SQuadTreeHeader* header = reinterpret_cast<const SQuadTreeHeader*>(bytes);
+        if (header->Magic != QuadTreeMagic ||
+            header->Version != FormatVersion ||
+            header->NodeCount == 0 ||
+            header->NodesOffset % alignof(SQuadTreeNode) != 0 ||
+            header->ObjectsOffset % alignof(SQuadTreeObject) != 0) return;
+
+        uint64_t nodesSize = uint64_t(header->NodeCount) * sizeof(SQuadTreeNode);
+        uint64_t objectsSize = uint64_t(header->ObjectCount) * sizeof(SQuadTreeObject);
+        if (header->NodesOffset > Size || nodesSize > Size - header->NodesOffset) return;
+        if (header->ObjectsOffset > Size || objectsSize > Size - header->ObjectsOffset) return;
+
+        Header = header;
+        Nodes = reinterpret_cast<const SQuadTreeNode*>(bytes + header->NodesOffset);
+        Objects = reinterpret_cast<const SQuadTreeObject*>(bytes + header->ObjectsOffset);
+    }
+
+    void CQuadTreeView::Query(const CRectangle& Area, std::vector<uint64_t>& Result) const {
+        if (!IsValid()) return;
+
+        // Depth-first with an explicit stack, every pop pushes at most 4 nodes
+        const int capacity = 3 * MaxDepth + 4;
+        uint32_t stack[capacity];
+        int top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const SQuadTreeNode& node = Nodes[stack[--top]];
+            bool overlap = Area.TopLeft.X <= node.MaxX && node.MinX <= Area.BottomRight.X &&
+                           Area.TopLeft.Y <= node.MaxY && node.MinY <= Area.BottomRight.Y;
+            if (!overlap) continue;
+
+            if (node.FirstChild == NoIndex) {
+                if (node.FirstObject > Header->ObjectCount ||
+                    node.ObjectCount > Header->ObjectCount - node.FirstObject) continue;
+
+                const SQuadTreeObject* objects = Objects + node.FirstObject;
+                for (uint32_t i = 0; i < node.ObjectCount; ++i) {
+                    const SQuadTreeObject& object = objects[i];
+                    if (Area.TopLeft.X <= object.MaxX && object.MinX <= Area.BottomRight.X &&
+                        Area.TopLeft.Y <= object.MaxY && object.MinY <= Area.BottomRight.Y) {
+                        Result.push_back(object.Id);
+                    }
+                }
+            } else {
+                // Children always sit after their parent, which also rules out cycles
+                if (node.FirstChild <= uint32_t(&node - Nodes) ||
+                    Header->NodeCount < 4 ||
+                    node.FirstChild > Header->NodeCount - 4 ||
+                    node.Depth >= MaxDepth ||
+                    top + 4 > capacity) continue;
+
+                for (uint32_t i = 0; i < 4; ++i) {
+                    stack[top++] = node.FirstChild + 3 - i;
+                }
+            }
+        }
+    }
+    // ===== QUADTREE =====
+
+
+
+    // ===== MATRIX =====
+    template<class T>
+    bool WriteMatrix(const Math::Matrix<T>& Matrix, std::ostream& out) {
+        int rows = Matrix.Rows();
+        int cols = Matrix.Cols();
+
+        SMatrixHeader header;
+        header.Magic = MatrixMagic;
+        header.Version = FormatVersion;
+        header.ScalarType = SScalarType<T>::Value;
+        header.ScalarSize = sizeof(T);
+        header.Rows = uint32_t(rows);
+        header.Cols = uint32_t(cols);
+        header.DataOffset = sizeof(SMatrixHeader);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (int i = 0; i < rows; ++i) {
+            out.write(reinterpret_cast<const char*>(Matrix[i]), cols * sizeof(T));
+        }
+        return bool(out);
+    }
+
+    template<class T>
+    bool WriteMatrix(const Math::Matrix<T>& Matrix, const std::string& Path) {
+        std::ofstream out(Path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        return WriteMatrix(Matrix, out);
+    }
+
+
+    template bool WriteMatrix<int>(const Math::Matrix<int>&, std::ostream&);
+    template bool WriteMatrix<int>(const Math::Matrix<int>&, const std::string&);
+    template bool WriteMatrix<float>(const Math::Matrix<float>&, std::ostream&);
+    template bool WriteMatrix<float>(const Math::Matrix<float>&, const std::string&);
+    template bool WriteMatrix<double>(const Math::Matrix<double>&, std::ostream&);
+    template bool WriteMatrix<double>(const Math::Matrix<double>&, const std::string&);
+    // ===== MATRIX =====
+}
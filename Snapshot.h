@@ -0,0 +1,218 @@
+/* Snapshots:
+ * Binary QuadTree snapshot
+ * Binary Matrix snapshot
+ * Memory mapped read-only views
+ * */
+
+#ifndef MATH_SNAPSHOT_H
+#define MATH_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "MATH.h"
+#include "QuadTree.h"
+
+namespace Snapshot {
+    using Geometry_2D::CRectangle;
+
+    // Snapshots are written in host byte order. A file written on a machine
+    // with another endianness fails the magic check instead of being misread.
+    const uint32_t QuadTreeMagic = 0x5451534D; // "MSQT"
+    const uint32_t MatrixMagic = 0x584D534D;   // "MSMX"
+    const uint32_t FormatVersion = 1;
+
+    const uint32_t NoIndex = 0xFFFFFFFF;
+    const uint32_t MaxDepth = 32;
+
+
+    // ===== FILE LAYOUT =====
+    // Every offset is relative to the beginning of the snapshot, so the same
+    // bytes can be mapped at any address and shared between processes.
+    //
+    // QuadTree: [SQuadTreeHeader][SQuadTreeNode * NodeCount][SQuadTreeObject * ObjectCount]
+    // Nodes are stored breadth-first, the 4 children of a node are consecutive.
+    struct SQuadTreeHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t NodeCount;
+        uint32_t ObjectCount;
+        uint64_t NodesOffset;
+        uint64_t ObjectsOffset;
+    };
+
+    struct SQuadTreeNode {
+        float MinX, MinY, MaxX, MaxY;
+        uint32_t FirstChild; // NoIndex for leaves
+        uint32_t FirstObject;
+        uint32_t ObjectCount;
+        uint32_t Depth;
+    };
+
+    struct SQuadTreeObject {
+        uint64_t Id;
+        float MinX, MinY, MaxX, MaxY;
+    };
+
+    // Matrix: [SMatrixHeader][T * Rows * Cols], row-major
+    enum EScalarType : uint32_t {
+        EINT32 = 1,
+        EFLOAT32 = 2,
+        EFLOAT64 = 3
+    };
+
+    struct SMatrixHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t ScalarType;
+        uint32_t ScalarSize;
+        uint32_t Rows;
+        uint32_t Cols;
+        uint64_t DataOffset;
+    };
+
+    static_assert(sizeof(SQuadTreeHeader) == 32, "SQuadTreeHeader layout changed");
+    static_assert(sizeof(SQuadTreeNode) == 32, "SQuadTreeNode layout changed");
+    static_assert(sizeof(SQuadTreeObject) == 24, "SQuadTreeObject layout changed");
+    static_assert(sizeof(SMatrixHeader) == 32, "SMatrixHeader layout changed");
+
+    template<class T> struct SScalarType;
+    template<> struct SScalarType<int32_t> { static const uint32_t Value = EINT32; };
+    template<> struct SScalarType<float> { static const uint32_t Value = EFLOAT32; };
+    template<> struct SScalarType<double> { static const uint32_t Value = EFLOAT64; };
+    // ===== FILE LAYOUT =====
+
+
+
+    // ===== MAPPED FILE =====
+    // Read-only, shared mapping of a whole file
+    class CMappedFile {
+        const unsigned char* Data;
+        size_t Size;
+
+    public:
+        CMappedFile();
+        explicit CMappedFile(const std::string& Path);
+        CMappedFile(CMappedFile&& Other);
+        CMappedFile(const CMappedFile&) = delete;
+        CMappedFile& operator=(const CMappedFile&) = delete;
+        ~CMappedFile();
+
+        bool Open(const std::string& Path);
+        void Close();
+
+        inline bool IsOpen() const { return Data != nullptr; }
+        inline const void* GetData() const { return Data; }
+        inline size_t GetSize() const { return Size; }
+    };
+    // ===== MAPPED FILE =====
+
+
+
+    // ===== QUADTREE =====
+    // Returns the id stored for an object of the tree
+    typedef std::function<uint64_t(const Collision::QuadTreeData&)> ObjectIdFunction;
+
+    bool WriteQuadTree(const Collision::QuadTreeNode& Root,
+                       const ObjectIdFunction& GetObjectId,
+                       std::ostream& out);
+
+    bool WriteQuadTree(const Collision::QuadTreeNode& Root,
+                       const ObjectIdFunction& GetObjectId,
+                       const std::string& Path);
+
+    // Builds a snapshot straight from a stream of objects without keeping
+    // them in memory. ForEachChunk is called once per pass (3 passes) and has
+    // to feed every object to the given function, chunk by chunk. Memory use
+    // is bounded by the tree shape, not by the number of objects; out has to
+    // be seekable.
+    // Nodes are split with the same maxDepth/maxObjectsPerNode limits as
+    // QuadTreeNode::Insert, but the split decision uses an upper bound of the
+    // objects in a node, so the tree can be slightly deeper than an inserted one.
+    typedef std::function<void(const SQuadTreeObject* Objects, size_t Count)> ObjectChunkFunction;
+    typedef std::function<void(const ObjectChunkFunction&)> ObjectStreamFunction;
+
+    // The grid used to shape the tree is 2^(StreamMaxDepth-1) cells wide
+    const int StreamMaxDepth = 11;
+    // Budget for the per-leaf write buffers of the last pass
+    const size_t StreamBufferBytes = 16 * 1024 * 1024;
+
+    bool WriteQuadTree(const CRectangle& Bounds,
+                       const ObjectStreamFunction& ForEachChunk,
+                       std::ostream& out);
+
+    bool WriteQuadTree(const CRectangle& Bounds,
+                       const ObjectStreamFunction& ForEachChunk,
+                       const std::string& Path);
+
+    // Queries a snapshot in place, nothing is parsed or copied.
+    // The memory has to outlive the view.
+    class CQuadTreeView {
+        const SQuadTreeHeader* Header;
+        const SQuadTreeNode* Nodes;
+        const SQuadTreeObject* Objects;
+
+    public:
+        CQuadTreeView();
+        CQuadTreeView(const void* Data, size_t Size);
+
+        inline bool IsValid() const { return Header != nullptr; }
+        inline uint32_t NumNodes() const { return IsValid() ? Header->NodeCount : 0; }
+        inline uint32_t NumObjects() const { return IsValid() ? Header->ObjectCount : 0; }
+
+        inline const SQuadTreeNode& GetNode(uint32_t Index) const { return Nodes[Index]; }
+        inline const SQuadTreeObject* GetObjects(const SQuadTreeNode& Node) const {
+            return Objects + Node.FirstObject;
+        }
+
+        // Same semantics as QuadTreeNode::Query: appends the ids of every
+        // object overlapping the area, once per leaf it is stored in
+        void Query(const CRectangle& Area, std::vector<uint64_t>& Result) const;
+    };
+    // ===== QUADTREE =====
+
+
+
+    // ===== MATRIX =====
+    template<class T>
+    bool WriteMatrix(const Math::Matrix<T>& Matrix, std::ostream& out);
+
+    template<class T>
+    bool WriteMatrix(const Math::Matrix<T>& Matrix, const std::string& Path);
+
+    template<class T>
+    class CMatrixView {
+        const SMatrixHeader* Header;
+        const T* Data;
+
+    public:
+        inline CMatrixView() : Header(nullptr), Data(nullptr) {}
+        inline CMatrixView(const void* Memory, size_t Size) : Header(nullptr), Data(nullptr) {
+            if (Memory == nullptr || Size < sizeof(SMatrixHeader)) return;
+
+            const SMatrixHeader* header = static_cast<const SMatrixHeader*>(Memory);
+            if (header->Magic != MatrixMagic ||
+                header->Version != FormatVersion ||
+                header->ScalarType != SScalarType<T>::Value ||
+                header->ScalarSize != sizeof(T) ||
+                header->DataOffset % alignof(T) != 0) return;
+
+            uint64_t dataSize = uint64_t(header->Rows) * header->Cols * sizeof(T);
+            if (header->DataOffset > Size || dataSize > Size - header->DataOffset) return;
+
+            Header = header;
+            Data = reinterpret_cast<const T*>(static_cast<const unsigned char*>(Memory) + header->DataOffset);
+        }
+
+        inline bool IsValid() const { return Header != nullptr; }
+        inline int Rows() const { return IsValid() ? int(Header->Rows) : 0; }
+        inline int Cols() const { return IsValid() ? int(Header->Cols) : 0; }
+
+        inline const T* operator[](int index) const { return Data + size_t(index) * Header->Cols; }
+    };
+    // ===== MATRIX =====
+}
+
+#endif //MATH_SNAPSHOT_H
@@ -0,0 +1,491 @@
+/* Sparse matrices:
+ * COO builder
+ * CSR (compressed rows) and CSC (compressed columns)
+ * SpMV, SpMM with a dense Matrix, transpose, addition
+ * */
+
+#include "Sparse.h"
+#include <algorithm>
+#include <utility>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Math {
+    // CSR and CSC share the same compressed layout: offsets per "major"
+    // index (rows for CSR, columns for CSC) and sorted "minor" indices.
+
+    // Contiguous ranges of majors handled by one thread each, 1 without OpenMP
+    static int BlockCount(int MajorCount) {
+#ifdef _OPENMP
+        int blocks = omp_get_max_threads();
+#else
+        int blocks = 1;
+#endif
+        // not worth a thread below a few hundred majors
+        int limit = MajorCount / 256;
+        if (blocks > limit) blocks = limit;
+        return blocks < 1 ? 1 : blocks;
+    }
+
+    static inline int BlockBegin(int MajorCount, int Blocks, int Block) {
+        return int((long long)(MajorCount) * Block / Blocks);
+    }
+
+    // Counting sort of the triplets by major index, then every major slice is
+    // sorted by minor index and its duplicates are summed
+    template<class T>
+    static void Compress(int MajorCount,
+                         const std::vector<int>& Major,
+                         const std::vector<int>& Minor,
+                         const std::vector<T>& Input,
+                         std::vector<int>& Offsets,
+                         std::vector<int>& Indices,
+                         std::vector<T>& Values) {
+        int count = int(Input.size());
+
+        Offsets.assign(MajorCount + 1, 0);
+        for (int i = 0; i < count; ++i) {
+            Offsets[Major[i] + 1] += 1;
+        }
+        for (int i = 0; i < MajorCount; ++i) {
+            Offsets[i + 1] += Offsets[i];
+        }
+
+        std::vector<std::pair<int, T>> entries(count);
+        std::vector<int> cursor(Offsets.begin(), Offsets.end() - 1);
+        for (int i = 0; i < count; ++i) {
+            entries[cursor[Major[i]]++] = std::make_pair(Minor[i], Input[i]);
+        }
+
+        Indices.clear();
+        Values.clear();
+        Indices.reserve(count);
+        Values.reserve(count);
+
+        int begin = 0;
+        for (int i = 0; i < MajorCount; ++i) {
+            int end = Offsets[i + 1];
+            std::sort(entries.begin() + begin, entries.begin() + end,
+                      [](const std::pair<int, T>& a, const std::pair<int, T>& b) { return a.first < b.first; });
+
+            Offsets[i] = int(Indices.size());
+            for (int k = begin; k < end; ++k) {
+                if (int(Indices.size()) > Offsets[i] && entries[k].first == Indices.back()) {
+                    Values.back() += entries[k].second;
+                } else {
+                    Indices.push_back(entries[k].first);
+                    Values.push_back(entries[k].second);
+                }
+            }
+            begin = end;
+        }
+        Offsets[MajorCount] = int(Indices.size());
+    }
+
+    // Swaps major and minor. Every block of majors counts its minors, the
+    // counts are turned into per block write positions, then the blocks
+    // scatter in parallel. Blocks are in major order, so the result comes
+    // out sorted.
+    template<class T>
+    static void TransposeCompressed(int MajorCount, int MinorCount,
+                                    const std::vector<int>& Offsets,
+                                    const std::vector<int>& Indices,
+                                    const std::vector<T>& Values,
+                                    std::vector<int>& OutOffsets,
+                                    std::vector<int>& OutIndices,
+                                    std::vector<T>& OutValues) {
+        int count = int(Values.size());
+        int blocks = BlockCount(MajorCount);
+
+        // cursors[b * MinorCount + j]: entries of block b in minor j, then where block b writes them
+        std::vector<int> cursors(size_t(blocks) * MinorCount, 0);
+
+        #pragma omp parallel for schedule(static, 1)
+        for (int b = 0; b < blocks; ++b) {
+            int* cursor = cursors.data() + size_t(b) * MinorCount;
+            for (int i = BlockBegin(MajorCount, blocks, b); i < BlockBegin(MajorCount, blocks, b + 1); ++i) {
+                for (int k = Offsets[i]; k < Offsets[i + 1]; ++k) {
+                    cursor[Indices[k]] += 1;
+                }
+            }
+        }
+
+        OutOffsets.resize(MinorCount + 1);
+        int position = 0;
+        for (int j = 0; j < MinorCount; ++j) {
+            OutOffsets[j] = position;
+            for (int b = 0; b < blocks; ++b) {
+                int entries = cursors[size_t(b) * MinorCount + j];
+                cursors[size_t(b) * MinorCount + j] = position;
+                position += entries;
+            }
+        }
+        OutOffsets[MinorCount] = count;
+
+        OutIndices.resize(count);
+        OutValues.resize(count);
+
+        #pragma omp parallel for schedule(static, 1)
+        for (int b = 0; b < blocks; ++b) {
+            int* cursor = cursors.data() + size_t(b) * MinorCount;
+            for (int i = BlockBegin(MajorCount, blocks, b); i < BlockBegin(MajorCount, blocks, b + 1); ++i) {
+                for (int k = Offsets[i]; k < Offsets[i + 1]; ++k) {
+                    int target = cursor[Indices[k]]++;
+                    OutIndices[target] = i;
+                    OutValues[target] = Values[k];
+                }
+            }
+        }
+    }
+
+    // Merges two compressed matrices of the same shape, zero sums are dropped.
+    // Passes over the majors in parallel: one counts the merged entries, the
+    // second writes them at the prefix sums of the counts.
+    template<class T>
+    static void AddCompressed(int MajorCount,
+                              const std::vector<int>& OffsetsA,
+                              const std::vector<int>& IndicesA,
+                              const std::vector<T>& ValuesA,
+                              const std::vector<int>& OffsetsB,
+                              const std::vector<int>& IndicesB,
+                              const std::vector<T>& ValuesB,
+                              std::vector<int>& Offsets,
+                              std::vector<int>& Indices,
+                              std::vector<T>& Values) {
+        Offsets.assign(MajorCount + 1, 0);
+
+        for (int pass = 0; pass < 2; ++pass) {
+            bool write = pass == 1;
+
+            #pragma omp parallel for schedule(dynamic, 256)
+            for (int i = 0; i < MajorCount; ++i) {
+                int a = OffsetsA[i], endA = OffsetsA[i + 1];
+                int b = OffsetsB[i], endB = OffsetsB[i + 1];
+                int position = write ? Offsets[i] : 0;
+
+                while (a < endA || b < endB) {
+                    int index;
+                    T value;
+                    if (b >= endB || (a < endA && IndicesA[a] < IndicesB[b])) {
+                        index = IndicesA[a];
+                        value = ValuesA[a++];
+                    } else if (a >= endA || IndicesB[b] < IndicesA[a]) {
+                        index = IndicesB[b];
+                        value = ValuesB[b++];
+                    } else {
+                        index = IndicesA[a];
+                        value = ValuesA[a++] + ValuesB[b++];
+                    }
+
+                    if (value != T(0)) {
+                        if (write) {
+                            Indices[position] = index;
+                            Values[position] = value;
+                        }
+                        ++position;
+                    }
+                }
+                if (!write) Offsets[i + 1] = position;
+            }
+
+            if (!write) {
+                for (int i = 0; i < MajorCount; ++i) {
+                    Offsets[i + 1] += Offsets[i];
+                }
+                Indices.resize(Offsets[MajorCount]);
+                Values.resize(Offsets[MajorCount]);
+            }
+        }
+    }
+
+
+
+    // ===== CSR =====
+    template<class T>
+    CsrMatrix<T>::CsrMatrix() : N(0), M(0), RowOffsets(1, 0) {}
+
+    template<class T>
+    CsrMatrix<T>::CsrMatrix(int Rows, int Cols,
+                            std::vector<int> Offsets,
+                            std::vector<int> Indices,
+                            std::vector<T> NonZeroValues) :
+            N(Rows),
+            M(Cols),
+            RowOffsets(std::move(Offsets)),
+            ColIndices(std::move(Indices)),
+            Values(std::move(NonZeroValues)) {}
+
+    template<class T>
+    CsrMatrix<T>::CsrMatrix(const CooMatrix<T>& Coo) : N(Coo.Rows()), M(Coo.Cols()) {
+        Compress(N, Coo.RowIndices, Coo.ColIndices, Coo.Values, RowOffsets, ColIndices, Values);
+    }
+
+    template<class T>
+    CsrMatrix<T>::CsrMatrix(const Matrix<T>& Dense) :
+            N(Dense.Rows()),
+            M(Dense.Cols()),
+            RowOffsets(N + 1, 0) {
+        for (int i = 0; i < N; ++i) {
+            const T* row = Dense[i];
+            for (int j = 0; j < M; ++j) {
+                if (row[j] != T(0)) {
+                    ColIndices.push_back(j);
+                    Values.push_back(row[j]);
+                }
+            }
+            RowOffsets[i + 1] = int(Values.size());
+        }
+    }
+
+    template<class T>
+    Matrix<T> CsrMatrix<T>::ToDense() const {
+        Matrix<T> Dense(N, M);
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int i = 0; i < N; ++i) {
+            T* row = Dense[i];
+            for (int k = RowOffsets[i]; k < RowOffsets[i + 1]; ++k) {
+                row[ColIndices[k]] = Values[k];
+            }
+        }
+        return Dense;
+    }
+
+    template<class T>
+    CscMatrix<T> CsrMatrix<T>::ToCsc() const {
+        std::vector<int> offsets, indices;
+        std::vector<T> values;
+        TransposeCompressed(N, M, RowOffsets, ColIndices, Values, offsets, indices, values);
+        return CscMatrix<T>(N, M, std::move(offsets), std::move(indices), std::move(values));
+    }
+
+    template<class T>
+    CsrMatrix<T> CsrMatrix<T>::GetTranspose() const {
+        // the CSC arrays of A are the CSR arrays of A^T
+        std::vector<int> offsets, indices;
+        std::vector<T> values;
+        TransposeCompressed(N, M, RowOffsets, ColIndices, Values, offsets, indices, values);
+        return CsrMatrix<T>(M, N, std::move(offsets), std::move(indices), std::move(values));
+    }
+
+    template<class T>
+    void CsrMatrix<T>::Multiply(const T* x, T* y) const {
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int i = 0; i < N; ++i) {
+            T sum = T(0);
+            for (int k = RowOffsets[i]; k < RowOffsets[i + 1]; ++k) {
+                sum += Values[k] * x[ColIndices[k]];
+            }
+            y[i] = sum;
+        }
+    }
+
+    template<class T>
+    std::vector<T> CsrMatrix<T>::operator*(const std::vector<T>& x) const {
+        if (int(x.size()) != M) return std::vector<T>();
+
+        std::vector<T> y(N);
+        Multiply(x.data(), y.data());
+        return y;
+    }
+
+    template<class T>
+    Matrix<T> CsrMatrix<T>::operator*(const Matrix<T>& B) const {
+        if (B.Rows() != M) return Matrix<T>();
+
+        int K = B.Cols();
+        Matrix<T> Result(N, K);
+
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < N; ++i) {
+            T* out = Result[i];
+            for (int k = RowOffsets[i]; k < RowOffsets[i + 1]; ++k) {
+                T value = Values[k];
+                const T* row = B[ColIndices[k]];
+                for (int j = 0; j < K; ++j) {
+                    out[j] += value * row[j];
+                }
+            }
+        }
+
+        return Result;
+    }
+
+    template<class T>
+    CsrMatrix<T> CsrMatrix<T>::operator+(const CsrMatrix<T>& B) const {
+        if (N != B.N || M != B.M) return CsrMatrix<T>();
+
+        std::vector<int> offsets, indices;
+        std::vector<T> values;
+        AddCompressed(N, RowOffsets, ColIndices, Values,
+                      B.RowOffsets, B.ColIndices, B.Values,
+                      offsets, indices, values);
+        return CsrMatrix<T>(N, M, std::move(offsets), std::move(indices), std::move(values));
+    }
+    // ===== CSR =====
+
+
+
+    // ===== CSC =====
+    template<class T>
+    CscMatrix<T>::CscMatrix() : N(0), M(0), ColOffsets(1, 0) {}
+
+    template<class T>
+    CscMatrix<T>::CscMatrix(int Rows, int Cols,
+                            std::vector<int> Offsets,
+                            std::vector<int> Indices,
+                            std::vector<T> NonZeroValues) :
+            N(Rows),
+            M(Cols),
+            ColOffsets(std::move(Offsets)),
+            RowIndices(std::move(Indices)),
+            Values(std::move(NonZeroValues)) {}
+
+    template<class T>
+    CscMatrix<T>::CscMatrix(const CooMatrix<T>& Coo) : N(Coo.Rows()), M(Coo.Cols()) {
+        Compress(M, Coo.ColIndices, Coo.RowIndices, Coo.Values, ColOffsets, RowIndices, Values);
+    }
+
+    template<class T>
+    CscMatrix<T>::CscMatrix(const Matrix<T>& Dense) :
+            N(Dense.Rows()),
+            M(Dense.Cols()),
+            ColOffsets(M + 1, 0) {
+        for (int j = 0; j < M; ++j) {
+            for (int i = 0; i < N; ++i) {
+                T value = Dense[i][j];
+                if (value != T(0)) {
+                    RowIndices.push_back(i);
+                    Values.push_back(value);
+                }
+            }
+            ColOffsets[j + 1] = int(Values.size());
+        }
+    }
+
+    template<class T>
+    Matrix<T> CscMatrix<T>::ToDense() const {
+        Matrix<T> Dense(N, M);
+        // every column writes its own cells
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int j = 0; j < M; ++j) {
+            for (int k = ColOffsets[j]; k < ColOffsets[j + 1]; ++k) {
+                Dense[RowIndices[k]][j] = Values[k];
+            }
+        }
+        return Dense;
+    }
+
+    template<class T>
+    CsrMatrix<T> CscMatrix<T>::ToCsr() const {
+        std::vector<int> offsets, indices;
+        std::vector<T> values;
+        TransposeCompressed(M, N, ColOffsets, RowIndices, Values, offsets, indices, values);
+        return CsrMatrix<T>(N, M, std::move(offsets), std::move(indices), std::move(values));
+    }
+
+    template<class T>
+    CscMatrix<T> CscMatrix<T>::GetTranspose() const {
+        // the CSR arrays of A are the CSC arrays of A^T
+        std::vector<int> offsets, indices;
+        std::vector<T> values;
+        TransposeCompressed(M, N, ColOffsets, RowIndices, Values, offsets, indices, values);
+        return CscMatrix<T>(M, N, std::move(offsets), std::move(indices), std::move(values));
+    }
+
+    template<class T>
+    void CscMatrix<T>::Multiply(const T* x, T* y) const {
+        // columns scatter into the same rows, so every block of columns sums
+        // into its own copy of y and the copies are added up at the end
+        int blocks = BlockCount(M);
+        if (blocks == 1) {
+            std::fill(y, y + N, T(0));
+            for (int j = 0; j < M; ++j) {
+                T value = x[j];
+                for (int k = ColOffsets[j]; k < ColOffsets[j + 1]; ++k) {
+                    y[RowIndices[k]] += Values[k] * value;
+                }
+            }
+            return;
+        }
+
+        std::vector<T> partial(size_t(blocks) * N, T(0));
+
+        #pragma omp parallel for schedule(static, 1)
+        for (int b = 0; b < blocks; ++b) {
+            T* sum = partial.data() + size_t(b) * N;
+            for (int j = BlockBegin(M, blocks, b); j < BlockBegin(M, blocks, b + 1); ++j) {
+                T value = x[j];
+                for (int k = ColOffsets[j]; k < ColOffsets[j + 1]; ++k) {
+                    sum[RowIndices[k]] += Values[k] * value;
+                }
+            }
+        }
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < N; ++i) {
+            T sum = T(0);
+            for (int b = 0; b < blocks; ++b) {
+                sum += partial[size_t(b) * N + i];
+            }
+            y[i] = sum;
+        }
+    }
+
+    template<class T>
+    std::vector<T> CscMatrix<T>::operator*(const std::vector<T>& x) const {
+        if (int(x.size()) != M) return std::vector<T>();
+
+        std::vector<T> y(N);
+        Multiply(x.data(), y.data());
+        return y;
+    }
+
+    template<class T>
+    Matrix<T> CscMatrix<T>::operator*(const Matrix<T>& B) const {
+        if (B.Rows() != M) return Matrix<T>();
+
+        int K = B.Cols();
+        Matrix<T> Result(N, K);
+
+        // split over the columns of B, so threads never write the same cell
+        const int width = 16;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int first = 0; first < K; first += width) {
+            int last = first + width < K ? first + width : K;
+            for (int j = 0; j < M; ++j) {
+                const T* row = B[j];
+                for (int k = ColOffsets[j]; k < ColOffsets[j + 1]; ++k) {
+                    T value = Values[k];
+                    T* out = Result[RowIndices[k]];
+                    for (int c = first; c < last; ++c) {
+                        out[c] += value * row[c];
+                    }
+                }
+            }
+        }
+
+        return Result;
+    }
+
+    template<class T>
+    CscMatrix<T> CscMatrix<T>::operator+(const CscMatrix<T>& B) const {
+        if (N != B.N || M != B.M) return CscMatrix<T>();
+
+        std::vector<int> offsets, indices;
+        std::vector<T> values;
+        AddCompressed(M, ColOffsets, RowIndices, Values,
+                      B.ColOffsets, B.RowIndices, B.Values,
+                      offsets, indices, values);
+        return CscMatrix<T>(N, M, std::move(offsets), std::move(indices), std::move(values));
+    }
+    // ===== CSC =====
+
+
+    template class CsrMatrix<int>;
+    template class CsrMatrix<float>;
+    template class CsrMatrix<double>;
+    template class CscMatrix<int>;
+    template class CscMatrix<float>;
+    template class CscMatrix<double>;
+}
@@ -0,0 +1,163 @@
+/* Sparse matrices:
+ * COO builder
+ * CSR (compressed rows) and CSC (compressed columns)
+ * SpMV, SpMM with a dense Matrix, transpose, addition
+ * */
+
+#ifndef MATH_SPARSE_H
+#define MATH_SPARSE_H
+
+#include <vector>
+#include "MATH.h"
+
+namespace Math {
+    template<class T> class CsrMatrix;
+    template<class T> class CscMatrix;
+
+    // ===== COO =====
+    // Unordered (row, column, value) triplets, used to assemble a matrix.
+    // Duplicates are summed when the matrix gets compressed.
+    template<class T>
+    class CooMatrix {
+        int N;
+        int M;
+
+    public:
+        std::vector<int> RowIndices;
+        std::vector<int> ColIndices;
+        std::vector<T> Values;
+
+        inline CooMatrix(int Rows = 0, int Cols = 0) : N(Rows), M(Cols) {}
+
+        inline int Rows() const { return N; }
+        inline int Cols() const { return M; }
+        inline int NonZeros() const { return int(Values.size()); }
+
+        inline void Reserve(int Count) {
+            RowIndices.reserve(Count);
+            ColIndices.reserve(Count);
+            Values.reserve(Count);
+        }
+
+        // entries outside of the matrix are ignored
+        inline void Add(int Row, int Col, T Value) {
+            if (Row < 0 || Row >= N || Col < 0 || Col >= M) return;
+            RowIndices.push_back(Row);
+            ColIndices.push_back(Col);
+            Values.push_back(Value);
+        }
+    };
+    // ===== COO =====
+
+
+
+    // ===== CSR =====
+    // Row i holds ColIndices/Values in [RowOffsets[i], RowOffsets[i + 1]),
+    // columns sorted and unique. Products, transpose and addition run in
+    // parallel over the rows when the library is built with OpenMP.
+    template<class T>
+    class CsrMatrix {
+        int N;
+        int M;
+        std::vector<int> RowOffsets;
+        std::vector<int> ColIndices;
+        std::vector<T> Values;
+
+    public:
+        CsrMatrix();
+
+        CsrMatrix(int Rows, int Cols,
+                  std::vector<int> Offsets,
+                  std::vector<int> Indices,
+                  std::vector<T> NonZeroValues);
+
+        explicit CsrMatrix(const CooMatrix<T>& Coo);
+
+        // zeros of the dense matrix are skipped
+        explicit CsrMatrix(const Matrix<T>& Dense);
+
+        inline int Rows() const { return N; }
+        inline int Cols() const { return M; }
+        inline int NonZeros() const { return int(Values.size()); }
+
+        inline const std::vector<int>& GetRowOffsets() const { return RowOffsets; }
+        inline const std::vector<int>& GetColIndices() const { return ColIndices; }
+        inline const std::vector<T>& GetValues() const { return Values; }
+
+        Matrix<T> ToDense() const;
+
+        CscMatrix<T> ToCsc() const;
+
+        CsrMatrix<T> GetTranspose() const;
+
+        // SpMV: y = A * x, x has Cols() elements, y has Rows()
+        void Multiply(const T* x, T* y) const;
+
+        std::vector<T> operator*(const std::vector<T>& x) const;
+
+        // SpMM: A * B, returns an empty matrix when the sizes don't match
+        Matrix<T> operator*(const Matrix<T>& B) const;
+
+        // returns an empty matrix when the sizes don't match
+        CsrMatrix<T> operator+(const CsrMatrix<T>& B) const;
+    };
+    // ===== CSR =====
+
+
+
+    // ===== CSC =====
+    // Column j holds RowIndices/Values in [ColOffsets[j], ColOffsets[j + 1]),
+    // rows sorted and unique. Products scatter into the result, so SpMV sums
+    // per thread copies of y (extra memory of one y per thread) and SpMM
+    // splits the columns of B; transpose and addition run over the columns
+    // in parallel. CSR's SpMV needs no extra memory.
+    template<class T>
+    class CscMatrix {
+        int N;
+        int M;
+        std::vector<int> ColOffsets;
+        std::vector<int> RowIndices;
+        std::vector<T> Values;
+
+    public:
+        CscMatrix();
+
+        CscMatrix(int Rows, int Cols,
+                  std::vector<int> Offsets,
+                  std::vector<int> Indices,
+                  std::vector<T> NonZeroValues);
+
+        explicit CscMatrix(const CooMatrix<T>& Coo);
+
+        // zeros of the dense matrix are skipped
+        explicit CscMatrix(const Matrix<T>& Dense);
+
+        inline int Rows() const { return N; }
+        inline int Cols() const { return M; }
+        inline int NonZeros() const { return int(Values.size()); }
+
+        inline const std::vector<int>& GetColOffsets() const { return ColOffsets; }
+        inline const std::vector<int>& GetRowIndices() const { return RowIndices; }
+        inline const std::vector<T>& GetValues() const { return Values; }
+
+        Matrix<T> ToDense() const;
+
+        CsrMatrix<T> ToCsr() const;
+
+        CscMatrix<T> GetTranspose() const;
+
+        // SpMV: y = A * x, x has Cols() elements, y has Rows()
+        void Multiply(const T* x, T* y) const;
+
+        std::vector<T> operator*(const std::vector<T>& x) const;
+
+        // SpMM: A * B, returns an empty matrix when the sizes don't match
+        Matrix<T> operator*(const Matrix<T>& B) const;
+
+        // returns an empty matrix when the sizes don't match
+        CscMatrix<T> operator+(const CscMatrix<T>& B) const;
+    };
+    // ===== CSC =====
+}
+
+#endif //MATH_SPARSE_H
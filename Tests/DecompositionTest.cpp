@@ -0,0 +1,281 @@
+/* Decomposition test:
+ * LU, Cholesky and QR residuals, determinant and inverse
+ * Batched solvers against LU
+ * */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../Decomposition.h"
+
+using namespace Math;
+
+static int Failures = 0;
+
+static void Expect(bool Condition, const char* What) {
+    if (!Condition) {
+        std::printf("FAIL %s\n", What);
+        ++Failures;
+    }
+}
+
+static double Random() {
+    return 2.0 * double(std::rand()) / double(RAND_MAX) - 1.0;
+}
+
+static Matrix<double> RandomMatrix(int Rows, int Cols) {
+    Matrix<double> A(Rows, Cols);
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; ++j) A[i][j] = Random();
+    }
+    return A;
+}
+
+// ||A x - b|| / (||A|| ||x|| + ||b||), infinity norms
+static double Residual(const Matrix<double>& A, const std::vector<double>& x, const std::vector<double>& b) {
+    double residual = 0.0, normA = 0.0, normX = 0.0, normB = 0.0;
+    for (int i = 0; i < A.Rows(); ++i) {
+        double sum = -b[i], row = 0.0;
+        for (int j = 0; j < A.Cols(); ++j) {
+            sum += A[i][j] * x[j];
+            row += std::fabs(A[i][j]);
+        }
+        residual = std::fmax(residual, std::fabs(sum));
+        normA = std::fmax(normA, row);
+        normB = std::fmax(normB, std::fabs(b[i]));
+    }
+    for (int j = 0; j < A.Cols(); ++j) normX = std::fmax(normX, std::fabs(x[j]));
+    return residual / (normA * normX + normB);
+}
+
+static std::vector<double> RandomVector(int Size) {
+    std::vector<double> b(Size);
+    for (int i = 0; i < Size; ++i) b[i] = Random();
+    return b;
+}
+
+// sizes around and past LUBlockSize
+static const int Sizes[] = {1, 5, LUBlockSize - 1, LUBlockSize, LUBlockSize + 1, 2 * LUBlockSize + 7, 100};
+
+static void CheckLU() {
+    double worst = 0.0;
+    for (int n : Sizes) {
+        Matrix<double> A = RandomMatrix(n, n);
+        Matrix<double> LU(A);
+        std::vector<int> pivots;
+        if (!LUDecompose(LU, pivots)) {
+            Expect(false, "LUDecompose of a random matrix");
+            continue;
+        }
+        std::vector<double> b = RandomVector(n), x(b);
+        LUSolve(LU, pivots, x.data());
+        worst = std::fmax(worst, Residual(A, x, b));
+
+        // A A^-1 = I
+        Matrix<double> inverse = Inverse(A);
+        double error = 0.0;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double sum = 0.0;
+                for (int k = 0; k < n; ++k) sum += A[i][k] * inverse[k][j];
+                error = std::fmax(error, std::fabs(sum - (i == j ? 1.0 : 0.0)));
+            }
+        }
+        if (error > 1e-9) std::printf("  inverse %d: %g\n", n, error);
+        Expect(inverse.Rows() == n && error <= 1e-9, "A Inverse(A) = I");
+    }
+    std::printf("  LU residual %.2g\n", worst);
+    Expect(worst < 1e-12, "LU residual");
+
+    // singular: the last row repeats the first
+    Matrix<double> singular = RandomMatrix(2 * LUBlockSize + 7, 2 * LUBlockSize + 7);
+    for (int j = 0; j < singular.Cols(); ++j) singular[singular.Rows() - 1][j] = singular[0][j];
+    Matrix<double> LU(singular);
+    std::vector<int> pivots;
+    Expect(!LUDecompose(LU, pivots), "LUDecompose rejects a singular matrix");
+    Expect(Determinant(singular) == 0.0, "Determinant of a singular matrix is 0");
+    Expect(Inverse(singular).Rows() == 0, "Inverse of a singular matrix is empty");
+
+    Matrix<double> rectangular = RandomMatrix(4, 3);
+    Expect(!LUDecompose(rectangular, pivots), "LUDecompose rejects a non square matrix");
+}
+
+static void CheckDeterminant() {
+    // upper triangular with a known diagonal, rows swapped once
+    const int n = LUBlockSize + 9;
+    Matrix<double> A(n, n);
+    double expected = 1.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = i; j < n; ++j) A[i][j] = Random();
+        A[i][i] = 1.0 + 0.01 * i;
+        expected *= A[i][i];
+    }
+    for (int j = 0; j < n; ++j) {
+        double swap = A[3][j];
+        A[3][j] = A[n - 2][j];
+        A[n - 2][j] = swap;
+    }
+    double determinant = Determinant(A);
+    Expect(std::fabs(determinant + expected) <= 1e-12 * std::fabs(expected), "Determinant with one row swap");
+}
+
+static void CheckCholesky() {
+    double worst = 0.0;
+    for (int n : Sizes) {
+        // B B^T + n I is symmetric positive definite
+        Matrix<double> B = RandomMatrix(n, n);
+        Matrix<double> A(n, n);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double sum = i == j ? double(n) : 0.0;
+                for (int k = 0; k < n; ++k) sum += B[i][k] * B[j][k];
+                A[i][j] = sum;
+            }
+        }
+        Matrix<double> L(A);
+        if (!CholeskyDecompose(L)) {
+            Expect(false, "CholeskyDecompose of an SPD matrix");
+            continue;
+        }
+        std::vector<double> b = RandomVector(n), x(b);
+        CholeskySolve(L, x.data());
+        worst = std::fmax(worst, Residual(A, x, b));
+
+        // shifted down it has negative eigenvalues
+        if (n > 1) {
+            Matrix<double> indefinite(A);
+            for (int i = 0; i < n; ++i) indefinite[i][i] -= 10.0 * n * n;
+            Expect(!CholeskyDecompose(indefinite), "CholeskyDecompose rejects an indefinite matrix");
+        }
+    }
+    std::printf("  Cholesky residual %.2g\n", worst);
+    Expect(worst < 1e-12, "Cholesky residual");
+
+    Matrix<double> symmetric(2, 2);
+    symmetric[0][0] = 1.0; symmetric[0][1] = 2.0;
+    symmetric[1][0] = 2.0; symmetric[1][1] = 1.0;
+    Expect(!CholeskyDecompose(symmetric), "CholeskyDecompose rejects a symmetric non SPD matrix");
+}
+
+static void CheckQR() {
+    const int shapes[][2] = {{1, 1}, {LUBlockSize + 1, LUBlockSize + 1}, {100, 100}, {120, 45}, {7, 3}};
+    double worst = 0.0;
+    for (const int* shape : shapes) {
+        int n = shape[0], m = shape[1];
+        Matrix<double> A = RandomMatrix(n, m);
+        Matrix<double> QR(A);
+        std::vector<double> tau;
+        if (!QRDecompose(QR, tau)) {
+            Expect(false, "QRDecompose of a random matrix");
+            continue;
+        }
+        std::vector<double> b = RandomVector(n), x(b);
+        if (!QRSolve(QR, tau, x.data())) {
+            Expect(false, "QRSolve of a full rank matrix");
+            continue;
+        }
+        x.resize(m);
+
+        // least squares: the residual is orthogonal to the columns, A^T (A x - b) = 0
+        std::vector<double> r(n);
+        for (int i = 0; i < n; ++i) {
+            r[i] = -b[i];
+            for (int j = 0; j < m; ++j) r[i] += A[i][j] * x[j];
+        }
+        double error = 0.0, scale = 0.0;
+        for (int j = 0; j < m; ++j) {
+            double sum = 0.0;
+            for (int i = 0; i < n; ++i) sum += A[i][j] * r[i];
+            error = std::fmax(error, std::fabs(sum));
+        }
+        for (int i = 0; i < n; ++i) scale += std::fabs(b[i]);
+        worst = std::fmax(worst, error / (double(n) * scale));
+    }
+    std::printf("  QR normal equation residual %.2g\n", worst);
+    Expect(worst < 1e-12, "QR least squares residual");
+
+    // two equal columns, R is singular
+    Matrix<double> deficient = RandomMatrix(10, 4);
+    for (int i = 0; i < 10; ++i) deficient[i][3] = deficient[i][1];
+    std::vector<double> tau, b = RandomVector(10);
+    Expect(!QRDecompose(deficient, tau) || !QRSolve(deficient, tau, b.data()), "QRSolve rejects a rank deficient matrix");
+}
+
+// every system against LU, Count deliberately not a multiple of any SIMD width
+template<class T, int Size>
+static double CheckBatched(int (*Solve)(int, const T*, const T*, T*), int Count) {
+    const size_t elements = size_t(Size) * Count;
+    std::vector<T> A(elements * Size), b(elements), x(elements, T(1));
+    for (int s = 0; s < Count; ++s) {
+        for (int row = 0; row < Size; ++row) {
+            for (int col = 0; col < Size; ++col) {
+                // diagonally dominant, so float stays well conditioned
+                A[(row * Size + col) * Count + s] = T(Random() + (row == col ? Size : 0));
+            }
+            b[row * Count + s] = T(Random());
+        }
+    }
+    // first and last system singular: two equal rows of whole numbers, so
+    // the determinant rounds to exactly 0 in every formula
+    const int singularSystems[] = {0, Count - 1};
+    for (int s : singularSystems) {
+        for (int row = 0; row < Size; ++row) {
+            for (int col = 0; col < Size; ++col) {
+                A[(row * Size + col) * Count + s] = T(std::rand() % 9 - 4);
+            }
+        }
+        for (int col = 0; col < Size; ++col) A[(1 * Size + col) * Count + s] = A[(0 * Size + col) * Count + s];
+    }
+
+    int singular = Solve(Count, A.data(), b.data(), x.data());
+    Expect(singular == 2, "batched solver counts the singular systems");
+
+    double worst = 0.0;
+    for (int s = 0; s < Count; ++s) {
+        bool isSingular = s == 0 || s == Count - 1;
+        if (isSingular) {
+            bool zero = true;
+            for (int row = 0; row < Size; ++row) zero = zero && x[row * Count + s] == T(0);
+            Expect(zero, "batched solver gives x = 0 for a singular system");
+            continue;
+        }
+        Matrix<double> system(Size, Size);
+        std::vector<double> expected(Size);
+        for (int row = 0; row < Size; ++row) {
+            for (int col = 0; col < Size; ++col) system[row][col] = double(A[(row * Size + col) * Count + s]);
+            expected[row] = double(b[row * Count + s]);
+        }
+        std::vector<int> pivots;
+        LUDecompose(system, pivots);
+        LUSolve(system, pivots, expected.data());
+        for (int row = 0; row < Size; ++row) {
+            worst = std::fmax(worst, std::fabs(double(x[row * Count + s]) - expected[row]));
+        }
+    }
+    return worst;
+}
+
+static void CheckBatched() {
+    const int Count = 37;
+    double floatError = std::fmax(CheckBatched<float, 2>(SolveBatched2x2<float>, Count),
+                                  std::fmax(CheckBatched<float, 3>(SolveBatched3x3<float>, Count),
+                                            CheckBatched<float, 4>(SolveBatched4x4<float>, Count)));
+    double doubleError = std::fmax(CheckBatched<double, 2>(SolveBatched2x2<double>, Count),
+                                   std::fmax(CheckBatched<double, 3>(SolveBatched3x3<double>, Count),
+                                             CheckBatched<double, 4>(SolveBatched4x4<double>, Count)));
+    std::printf("  batched error float %.2g, double %.2g\n", floatError, doubleError);
+    Expect(floatError < 5e-7 && doubleError < 1e-12, "batched solvers match LU");
+}
+
+int main() {
+    std::srand(9);
+    CheckLU();
+    CheckDeterminant();
+    CheckCholesky();
+    CheckQR();
+    CheckBatched();
+
+    std::printf("%s\n", Failures == 0 ? "PASS" : "FAIL");
+    return Failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,212 @@
+/* Fixed point geometry test:
+ * FixedGeometry.h against the canonical float functions of MATH.h
+ * Accuracy of the fixed point functions
+ * */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../FixedGeometry.h"
+#include "../GJK.h"
+#include "../Benchmarks/Benchmark.h"
+
+using namespace Geometry_2D;
+using Math::Fixed16_16;
+using Math::Fixed32_32;
+using Benchmark::Scalar;
+
+static int Failures = 0;
+
+static void Expect(bool Condition, const char* What) {
+    if (!Condition) {
+        std::printf("FAIL %s\n", What);
+        ++Failures;
+    }
+}
+
+template<class T>
+static TVector_2D<T> Vector(const SVector_2D& Point) {
+    return TVector_2D<T>(Scalar<T>(Point.X), Scalar<T>(Point.Y));
+}
+
+template<class T>
+static TRectangle<T> Rectangle(const CRectangle& Rect) {
+    return TRectangle<T>(Vector<T>(Rect.TopLeft), Vector<T>(Rect.BottomRight));
+}
+
+static float RandomCoordinate() {
+    // whole and half units, exact in every scalar, with plenty of shared edges
+    return float(std::rand() % 80) * 0.5f;
+}
+
+static CRectangle RandomRectangle() {
+    return CreateRectangleIncludingTwoPoints(SVector_2D(RandomCoordinate(), RandomCoordinate()),
+                                             SVector_2D(RandomCoordinate(), RandomCoordinate()));
+}
+
+// the float, Q16.16 and Q32.32 instantiations have to agree with MATH.h
+template<class T>
+static void CheckRectangles(const char* Name) {
+    std::srand(3);
+    int mismatches = 0;
+    for (int i = 0; i < 20000; ++i) {
+        CRectangle a = RandomRectangle();
+        CRectangle b = RandomRectangle();
+        SVector_2D point(RandomCoordinate(), RandomCoordinate());
+
+        if (DoRectanglesOverlap(Rectangle<T>(a), Rectangle<T>(b)) != DoRectanglesOverlap(a, b)) ++mismatches;
+        if (IsPointInsideRect(Vector<T>(point), Rectangle<T>(a)) != IsPointInsideRect(point, a)) ++mismatches;
+
+        TRectangle<T> made = CreateRectangleIncludingTwoPoints(Vector<T>(a.BottomRight), Vector<T>(point));
+        CRectangle expected = CreateRectangleIncludingTwoPoints(a.BottomRight, point);
+        if (made.TopLeft != Vector<T>(expected.TopLeft) || made.BottomRight != Vector<T>(expected.BottomRight)) {
+            ++mismatches;
+        }
+    }
+    if (mismatches != 0) std::printf("  %s: %d rectangle mismatches\n", Name, mismatches);
+    Expect(mismatches == 0, "rectangle conventions match MATH.h");
+}
+
+// half unit coordinates keep these products exact in float
+static bool HasVertexOnEdgeLine(const SVector_2D* Triangle, const SVector_2D* Vertices) {
+    for (int e = 0; e < 3; ++e) {
+        SVector_2D a = Triangle[e];
+        SVector_2D b = Triangle[(e + 1) % 3];
+        for (int v = 0; v < 3; ++v) {
+            if ((b.X - a.X) * (Vertices[v].Y - a.Y) == (b.Y - a.Y) * (Vertices[v].X - a.X)) return true;
+        }
+    }
+    return false;
+}
+
+template<class T>
+static void CheckPolygons(const char* Name) {
+    std::srand(4);
+    int mismatches = 0;
+    for (int i = 0; i < 5000; ++i) {
+        SVector_2D points[6];
+        for (int v = 0; v < 6; ++v) points[v] = SVector_2D(RandomCoordinate(), RandomCoordinate());
+        // skip degenerate triangles, CPolygon has no normals for them
+        float area1 = (points[1].X - points[0].X) * (points[2].Y - points[0].Y) -
+                      (points[1].Y - points[0].Y) * (points[2].X - points[0].X);
+        float area2 = (points[4].X - points[3].X) * (points[5].Y - points[3].Y) -
+                      (points[4].Y - points[3].Y) * (points[5].X - points[3].X);
+        if (area1 == 0.0f || area2 == 0.0f) continue;
+        // CPolygon projects on unit normals, so whether exactly touching
+        // triangles overlap depends on its rounding
+        if (HasVertexOnEdgeLine(points, points + 3) || HasVertexOnEdgeLine(points + 3, points)) continue;
+
+        CTriangle triangle1(points[0], points[1], points[2]);
+        CTriangle triangle2(points[3], points[4], points[5]);
+
+        TVector_2D<T> vertices[6];
+        for (int v = 0; v < 6; ++v) vertices[v] = Vector<T>(points[v]);
+
+        if (DoConvexPolygonsOverlap(vertices, 3, vertices + 3, 3) != DoPolygonsOverlap(triangle1, triangle2)) {
+            ++mismatches;
+        }
+    }
+    if (mismatches != 0) std::printf("  %s: %d polygon mismatches\n", Name, mismatches);
+    Expect(mismatches == 0, "convex polygon overlap matches DoPolygonsOverlap");
+}
+
+// Only the long hypotenuse separates these, its projections are far past
+// the Q16.16 range and used to wrap into a false overlap
+template<class T>
+static void CheckLargePolygons(const char* Name) {
+    const float scales[] = {1.0f, 163.0f};
+    for (float scale : scales) {
+        SVector_2D triangle[] = {SVector_2D(-100, -100) * scale, SVector_2D(100, -100) * scale,
+                                 SVector_2D(-100, 100) * scale};
+        SVector_2D square[] = {SVector_2D(1, 1) * scale, SVector_2D(5, 1) * scale,
+                               SVector_2D(5, 5) * scale, SVector_2D(1, 5) * scale};
+        SVector_2D touching[] = {SVector_2D(0, 0) * scale, SVector_2D(4, 0) * scale,
+                                 SVector_2D(4, 4) * scale, SVector_2D(0, 4) * scale};
+
+        TVector_2D<T> vertices[11];
+        for (int v = 0; v < 3; ++v) vertices[v] = Vector<T>(triangle[v]);
+        for (int v = 0; v < 4; ++v) vertices[3 + v] = Vector<T>(square[v]);
+        for (int v = 0; v < 4; ++v) vertices[7 + v] = Vector<T>(touching[v]);
+
+        bool separated = !DoConvexPolygonsOverlap(vertices, 3, vertices + 3, 4);
+        bool touches = DoConvexPolygonsOverlap(vertices, 3, vertices + 7, 4);
+        if (!separated || !touches) std::printf("  %s: wrong result at scale %g\n", Name, scale);
+        Expect(separated && touches, "convex polygon overlap up to half the fixed point range");
+    }
+}
+
+template<class T>
+static void CheckMinkowski() {
+    std::vector<SVector_2D> set1, set2;
+    for (int i = 0; i < 40; ++i) set1.push_back(SVector_2D(RandomCoordinate(), RandomCoordinate()));
+    for (int i = 0; i < 30; ++i) set2.push_back(SVector_2D(RandomCoordinate(), RandomCoordinate()));
+    std::vector<SVector_2D> expected = Collision::MinkowskiDiff(set1, set2);
+
+    std::vector<TVector_2D<T> > fixed1, fixed2, result;
+    for (size_t i = 0; i < set1.size(); ++i) fixed1.push_back(Vector<T>(set1[i]));
+    for (size_t i = 0; i < set2.size(); ++i) fixed2.push_back(Vector<T>(set2[i]));
+    Collision::MinkowskiDiff(fixed1.begin(), fixed1.end(), fixed2.begin(), fixed2.end(),
+                             [&](const TVector_2D<T>* Points, size_t Count) {
+                                 result.insert(result.end(), Points, Points + Count);
+                             });
+
+    bool same = result.size() == expected.size();
+    for (size_t i = 0; same && i < result.size(); ++i) same = result[i] == Vector<T>(expected[i]);
+    Expect(same, "streaming Minkowski difference on fixed point vectors");
+}
+
+template<class Fixed>
+static void CheckFunctions(const char* Name, double SinError, double Atan2Error, double SqrtError) {
+    double sinError = 0.0, atan2Error = 0.0, sqrtError = 0.0;
+    for (int i = -20000; i <= 20000; ++i) {
+        Fixed angle = Fixed::FromDouble(i * 0.001);
+        double a = angle.ToDouble();
+        sinError = std::fmax(sinError, std::fabs(Math::Sin(angle).ToDouble() - std::sin(a)));
+        sinError = std::fmax(sinError, std::fabs(Math::Cos(angle).ToDouble() - std::cos(a)));
+
+        Fixed y = Fixed::FromDouble(std::sin(i * 0.0007) * (1 + i % 7));
+        Fixed x = Fixed::FromDouble(std::cos(i * 0.0007) * (1 + i % 5));
+        atan2Error = std::fmax(atan2Error, std::fabs(Math::Atan2(y, x).ToDouble() -
+                                                     std::atan2(y.ToDouble(), x.ToDouble())));
+        if (a >= 0.0) {
+            sqrtError = std::fmax(sqrtError, std::fabs(Math::Sqrt(angle).ToDouble() - std::sqrt(a)));
+        }
+    }
+    std::printf("  %s: sin/cos %.2g, atan2 %.2g, sqrt %.2g\n", Name, sinError, atan2Error, sqrtError);
+    Expect(sinError <= SinError && atan2Error <= Atan2Error && sqrtError <= SqrtError,
+           "fixed point functions within the documented accuracy");
+}
+
+int main() {
+    CheckRectangles<float>("float");
+    CheckRectangles<Fixed16_16>("Q16.16");
+    CheckRectangles<Fixed32_32>("Q32.32");
+
+    CheckPolygons<float>("float");
+    CheckPolygons<Fixed16_16>("Q16.16");
+    CheckPolygons<Fixed32_32>("Q32.32");
+
+    CheckLargePolygons<float>("float");
+    CheckLargePolygons<Fixed16_16>("Q16.16");
+    CheckLargePolygons<Fixed32_32>("Q32.32");
+
+    CheckMinkowski<Fixed16_16>();
+    CheckMinkowski<Fixed32_32>();
+
+    // FixedPoint.h lists 5.2e-5, 3.0e-5, 1.5e-5 and 1.1e-9, 2.7e-9, 2.3e-10
+    CheckFunctions<Fixed16_16>("Q16.16", 5.3e-5, 3.1e-5, 1.6e-5);
+    CheckFunctions<Fixed32_32>("Q32.32", 1.2e-9, 2.8e-9, 2.4e-10);
+
+    // the QuadTree box of a fixed point rectangle contains it
+    TRectangle<Fixed16_16> fixedBox(TVector_2D<Fixed16_16>(Fixed16_16::FromDouble(0.1), Fixed16_16(-3)),
+                                    TVector_2D<Fixed16_16>(Fixed16_16::FromDouble(1000.3), Fixed16_16(7)));
+    CRectangle box = ToRectangle(fixedBox);
+    Expect(double(box.TopLeft.X) <= fixedBox.TopLeft.X.ToDouble() &&
+           double(box.TopLeft.Y) <= fixedBox.TopLeft.Y.ToDouble() &&
+           double(box.BottomRight.X) >= fixedBox.BottomRight.X.ToDouble() &&
+           double(box.BottomRight.Y) >= fixedBox.BottomRight.Y.ToDouble(), "ToRectangle rounds outwards");
+
+    std::printf("%s\n", Failures == 0 ? "PASS" : "FAIL");
+    return Failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,71 @@
+/* QuadTree nearest neighbour test:
+ * QueryNearest and QueryNearestBatch against brute force
+ * */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../QuadTree.h"
+
+using namespace Collision;
+using Geometry_2D::SVector_2D;
+using Geometry_2D::CRectangle;
+
+static float DistanceToBox(const SVector_2D& Point, const CRectangle& Box) {
+    float dx = std::max(std::max(Box.TopLeft.X - Point.X, Point.X - Box.BottomRight.X), 0.0f);
+    float dy = std::max(std::max(Box.TopLeft.Y - Point.Y, Point.Y - Box.BottomRight.Y), 0.0f);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+int main() {
+    const int K = 5;
+    const int PointCount = 100; // several packets and a partial one
+
+    QuadTree tree(CRectangle(SVector_2D(0.0f, 0.0f), SVector_2D(1024.0f, 1024.0f)));
+    std::vector<QuadTreeData> data;
+    data.reserve(300);
+    std::srand(11);
+    for (int i = 0; i < 300; ++i) {
+        float x = float(std::rand() % 1000);
+        float y = float(std::rand() % 1000);
+        data.push_back(QuadTreeData(nullptr, CRectangle(SVector_2D(x, y), SVector_2D(x + 12.0f, y + 12.0f))));
+    }
+    for (size_t i = 0; i < data.size(); ++i) tree.Insert(data[i]);
+
+    std::vector<SVector_2D> points;
+    for (int i = 0; i < PointCount; ++i) {
+        points.push_back(SVector_2D(float(std::rand() % 1100) - 50.0f, float(std::rand() % 1100) - 50.0f));
+    }
+
+    std::vector<QuadTreeData*> results(size_t(PointCount) * K);
+    std::vector<float> distances(size_t(PointCount) * K);
+    std::vector<int> found(PointCount);
+    tree.QueryNearestBatch(points.data(), PointCount, K, results.data(), distances.data(), found.data());
+
+    int failures = 0;
+    for (int p = 0; p < PointCount; ++p) {
+        std::vector<float> expected;
+        for (size_t i = 0; i < data.size(); ++i) expected.push_back(DistanceToBox(points[p], data[i].bounds));
+        std::sort(expected.begin(), expected.end());
+
+        QuadTreeData* single[K];
+        float singleDistances[K];
+        int singleFound = tree.QueryNearest(points[p], K, single, singleDistances);
+
+        bool ok = found[p] == K && singleFound == K;
+        for (int i = 0; ok && i < K; ++i) {
+            const float* batched = &distances[size_t(p) * K];
+            ok = batched[i] == singleDistances[i] && std::fabs(batched[i] - expected[i]) < 1e-3f &&
+                 std::fabs(DistanceToBox(points[p], results[size_t(p) * K + i]->bounds) - batched[i]) < 1e-3f;
+        }
+        if (!ok) {
+            std::printf("FAIL point %d (%g, %g)\n", p, points[p].X, points[p].Y);
+            ++failures;
+        }
+    }
+
+    std::printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+/* QuadTree raycast test:
+ * Axis aligned rays along split lines and object edges
+ * Random rays cast as one batch, several packets and a partial one
+ * */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../QuadTree.h"
+
+using namespace Collision;
+using Geometry_2D::SVector_2D;
+using Geometry_2D::CRectangle;
+
+static int Failures = 0;
+
+// nearest entry distance over every object, -1 for a miss
+static float BruteForce(const std::vector<QuadTreeData>& Data, const SRay& Ray) {
+    float best = -1.0f;
+    for (size_t i = 0; i < Data.size(); ++i) {
+        const CRectangle& box = Data[i].bounds;
+        float tMin = 0.0f, tMax = Ray.MaxDistance;
+        bool hit = true;
+        float origin[2] = {Ray.Origin.X, Ray.Origin.Y};
+        float direction[2] = {Ray.Direction.X, Ray.Direction.Y};
+        float minimum[2] = {box.TopLeft.X, box.TopLeft.Y};
+        float maximum[2] = {box.BottomRight.X, box.BottomRight.Y};
+        for (int axis = 0; axis < 2 && hit; ++axis) {
+            if (direction[axis] == 0.0f) {
+                hit = origin[axis] >= minimum[axis] && origin[axis] <= maximum[axis];
+                continue;
+            }
+            float t1 = (minimum[axis] - origin[axis]) / direction[axis];
+            float t2 = (maximum[axis] - origin[axis]) / direction[axis];
+            tMin = std::fmax(tMin, std::fmin(t1, t2));
+            tMax = std::fmin(tMax, std::fmax(t1, t2));
+        }
+        if (hit && tMin <= tMax && (best < 0.0f || tMin < best)) best = tMin;
+    }
+    return best;
+}
+
+static void Check(const QuadTree& Tree, const std::vector<QuadTreeData>& Data, const SRay& Ray) {
+    float expected = BruteForce(Data, Ray);
+
+    SRayHit hit;
+    bool found = Tree.Raycast(Ray, hit);
+    bool any = Tree.RaycastAny(Ray);
+    SRayHit batched;
+    Tree.RaycastBatch(&Ray, 1, &batched);
+
+    bool ok = found == (expected >= 0.0f) && any == found && (batched.Data != nullptr) == found;
+    if (ok && found) ok = hit.Distance == expected && batched.Distance == expected;
+    if (!ok) {
+        std::printf("FAIL ray (%g, %g) dir (%g, %g): expected %g, got %d %g, any %d, batch %g\n",
+                    Ray.Origin.X, Ray.Origin.Y, Ray.Direction.X, Ray.Direction.Y, expected,
+                    int(found), hit.Distance, int(any), batched.Data ? batched.Distance : -1.0f);
+        ++Failures;
+    }
+}
+
+static bool NearlyEqual(float a, float b) {
+    return std::fabs(a - b) <= 1e-4f * std::fmax(1.0f, std::fmax(std::fabs(a), std::fabs(b)));
+}
+
+// RaycastBatch against brute force and Raycast, for rays in any direction
+static void CheckBatch(const QuadTree& Tree, const std::vector<QuadTreeData>& Data, int Count) {
+    std::vector<SRay> rays;
+    for (int i = 0; i < Count; ++i) {
+        SVector_2D origin(float(std::rand() % 1224) - 100.0f, float(std::rand() % 1224) - 100.0f);
+        float angle = float(std::rand()) / float(RAND_MAX) * 6.2831853f;
+        float maxDistance = 200.0f + float(std::rand() % 1300);
+        rays.push_back(SRay(origin, SVector_2D(std::cos(angle), std::sin(angle)), maxDistance));
+    }
+
+    std::vector<SRayHit> hits(Count);
+    Tree.RaycastBatch(rays.data(), Count, hits.data());
+
+    int hitCount = 0;
+    for (int i = 0; i < Count; ++i) {
+        const SRay& ray = rays[i];
+        float expected = BruteForce(Data, ray);
+        SRayHit single;
+        bool found = Tree.Raycast(ray, single);
+
+        bool ok = (hits[i].Data != nullptr) == (expected >= 0.0f) && found == (hits[i].Data != nullptr);
+        if (ok && found) {
+            ok = NearlyEqual(hits[i].Distance, expected) && hits[i].Distance == single.Distance;
+            ++hitCount;
+        }
+        if (!ok) {
+            std::printf("FAIL batched ray %d (%g, %g) dir (%g, %g): expected %g, got %g, single %g\n",
+                        i, ray.Origin.X, ray.Origin.Y, ray.Direction.X, ray.Direction.Y, expected,
+                        hits[i].Data ? hits[i].Distance : -1.0f, found ? single.Distance : -1.0f);
+            ++Failures;
+        }
+    }
+    // both outcomes have to show up, or the batch tests nothing
+    if (hitCount == 0 || hitCount == Count) {
+        std::printf("FAIL batch of %d rays: %d hits\n", Count, hitCount);
+        ++Failures;
+    }
+}
+
+int main() {
+    QuadTree tree(CRectangle(SVector_2D(0.0f, 0.0f), SVector_2D(1024.0f, 1024.0f)));
+
+    std::vector<QuadTreeData> data;
+    data.reserve(201);
+    data.push_back(QuadTreeData(nullptr, CRectangle(SVector_2D(500.0f, 900.0f), SVector_2D(520.0f, 910.0f))));
+    std::srand(7);
+    for (int i = 0; i < 200; ++i) {
+        // whole numbers, so some edges land on split lines
+        float x = float(std::rand() % 1000);
+        float y = float(std::rand() % 1000);
+        data.push_back(QuadTreeData(nullptr, CRectangle(SVector_2D(x, y), SVector_2D(x + 16.0f, y + 16.0f))));
+    }
+    for (size_t i = 0; i < data.size(); ++i) tree.Insert(data[i]);
+
+    // along the split lines of the first levels, in all four directions
+    const float lines[] = {512.0f, 256.0f, 768.0f, 128.0f, 384.0f, 640.0f, 896.0f};
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); ++i) {
+        Check(tree, data, SRay(SVector_2D(lines[i], 0.0f), SVector_2D(0.0f, 1.0f), 2000.0f));
+        Check(tree, data, SRay(SVector_2D(lines[i], 1024.0f), SVector_2D(0.0f, -1.0f), 2000.0f));
+        Check(tree, data, SRay(SVector_2D(0.0f, lines[i]), SVector_2D(1.0f, 0.0f), 2000.0f));
+        Check(tree, data, SRay(SVector_2D(1024.0f, lines[i]), SVector_2D(-1.0f, 0.0f), 2000.0f));
+    }
+
+    // along the edges of every object
+    for (size_t i = 0; i < data.size(); ++i) {
+        const CRectangle& box = data[i].bounds;
+        Check(tree, data, SRay(SVector_2D(box.TopLeft.X, 0.0f), SVector_2D(0.0f, 1.0f), 2000.0f));
+        Check(tree, data, SRay(SVector_2D(box.BottomRight.X, 0.0f), SVector_2D(0.0f, 1.0f), 2000.0f));
+        Check(tree, data, SRay(SVector_2D(0.0f, box.TopLeft.Y), SVector_2D(1.0f, 0.0f), 2000.0f));
+        Check(tree, data, SRay(SVector_2D(0.0f, box.BottomRight.Y), SVector_2D(1.0f, 0.0f), 2000.0f));
+    }
+
+    // 31 full packets and a partial one
+    CheckBatch(tree, data, 1000);
+    CheckBatch(tree, data, RayPacketSize + 5);
+
+    // the reported case
+    SRayHit hit;
+    if (!tree.Raycast(SRay(SVector_2D(512.0f, 0.0f), SVector_2D(0.0f, 1.0f), 2000.0f), hit)) {
+        std::printf("FAIL ray along x = 512 missed\n");
+        ++Failures;
+    }
+
+    std::printf("%s\n", Failures == 0 ? "PASS" : "FAIL");
+    return Failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+/* Snapshot test:
+ * QuadTree snapshots, written from a tree and streamed, queried in place
+ * Matrix snapshots of every scalar type
+ * */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include "../Snapshot.h"
+
+using namespace Snapshot;
+using Collision::QuadTreeData;
+using Collision::QuadTreeNode;
+using Geometry_2D::SVector_2D;
+
+static int Failures = 0;
+
+static void Expect(bool Condition, const char* What) {
+    if (!Condition) {
+        std::printf("FAIL %s\n", What);
+        ++Failures;
+    }
+}
+
+// a copy in 8 byte aligned memory, like a mapping would be
+static std::vector<uint64_t> Aligned(const std::string& Bytes) {
+    std::vector<uint64_t> memory((Bytes.size() + 7) / 8);
+    std::memcpy(memory.data(), Bytes.data(), Bytes.size());
+    return memory;
+}
+
+static bool Overlap(const CRectangle& Area, const CRectangle& Box) {
+    return Area.TopLeft.X <= Box.BottomRight.X && Box.TopLeft.X <= Area.BottomRight.X &&
+           Area.TopLeft.Y <= Box.BottomRight.Y && Box.TopLeft.Y <= Area.BottomRight.Y;
+}
+
+static std::vector<uint64_t> Unique(std::vector<uint64_t> Ids) {
+    std::sort(Ids.begin(), Ids.end());
+    Ids.erase(std::unique(Ids.begin(), Ids.end()), Ids.end());
+    return Ids;
+}
+
+static void CheckQuadTree() {
+    const int ObjectCount = 2000;
+    const int QueryCount = 500;
+    // doesn't divide ObjectCount, so the last chunk is a partial one
+    const size_t ChunkSize = 7;
+
+    CRectangle bounds(SVector_2D(0.0f, 0.0f), SVector_2D(1024.0f, 1024.0f));
+    QuadTreeNode tree(bounds);
+    std::vector<QuadTreeData> data;
+    data.reserve(ObjectCount);
+    std::vector<SQuadTreeObject> objects;
+    std::srand(13);
+    for (int i = 0; i < ObjectCount; ++i) {
+        // whole numbers, so some edges land on split lines
+        float x = float(std::rand() % 1000);
+        float y = float(std::rand() % 1000);
+        float size = float(1 + std::rand() % 24);
+        data.push_back(QuadTreeData(nullptr, CRectangle(SVector_2D(x, y), SVector_2D(x + size, y + size))));
+        objects.push_back({uint64_t(i), x, y, x + size, y + size});
+    }
+    for (size_t i = 0; i < data.size(); ++i) tree.Insert(data[i]);
+
+    std::stringstream written;
+    Expect(WriteQuadTree(tree, [&](const QuadTreeData& Data) { return uint64_t(&Data - data.data()); }, written),
+           "WriteQuadTree from a tree");
+    std::vector<uint64_t> writtenMemory = Aligned(written.str());
+    CQuadTreeView writtenView(writtenMemory.data(), written.str().size());
+    Expect(writtenView.IsValid(), "view of a written tree");
+
+    int chunks = 0;
+    std::stringstream streamed;
+    Expect(WriteQuadTree(bounds, [&](const ObjectChunkFunction& Feed) {
+               for (size_t i = 0; i < objects.size(); i += ChunkSize) {
+                   Feed(objects.data() + i, std::min(ChunkSize, objects.size() - i));
+                   ++chunks;
+               }
+           }, streamed), "WriteQuadTree from a stream");
+    Expect(chunks == 3 * int((objects.size() + ChunkSize - 1) / ChunkSize), "the stream is read in 3 passes");
+    std::vector<uint64_t> streamedMemory = Aligned(streamed.str());
+    CQuadTreeView streamedView(streamedMemory.data(), streamed.str().size());
+    Expect(streamedView.IsValid(), "view of a streamed tree");
+
+    int mismatches = 0;
+    for (int q = 0; q < QueryCount; ++q) {
+        float x = float(std::rand() % 1100) - 50.0f;
+        float y = float(std::rand() % 1100) - 50.0f;
+        CRectangle area(SVector_2D(x, y), SVector_2D(x + float(std::rand() % 200), y + float(std::rand() % 200)));
+
+        std::vector<uint64_t> expected;
+        for (int i = 0; i < ObjectCount; ++i) {
+            if (Overlap(area, data[i].bounds)) expected.push_back(uint64_t(i));
+        }
+
+        // same tree, so the same ids as often as QuadTreeNode::Query returns them
+        std::vector<uint64_t> fromTree;
+        std::vector<QuadTreeData*> found = tree.Query(area);
+        for (size_t i = 0; i < found.size(); ++i) fromTree.push_back(uint64_t(found[i] - data.data()));
+        std::sort(fromTree.begin(), fromTree.end());
+
+        std::vector<uint64_t> fromWritten;
+        writtenView.Query(area, fromWritten);
+        std::sort(fromWritten.begin(), fromWritten.end());
+
+        // the streamed tree has its own shape, only the set of ids matches
+        std::vector<uint64_t> fromStreamed;
+        streamedView.Query(area, fromStreamed);
+
+        if (fromWritten != fromTree || Unique(fromTree) != expected || Unique(fromStreamed) != expected) {
+            ++mismatches;
+        }
+    }
+    if (mismatches != 0) std::printf("  %d of %d queries differ\n", mismatches, QueryCount);
+    Expect(mismatches == 0, "snapshot queries match QuadTreeNode::Query and brute force");
+
+    // corrupted or truncated snapshots are rejected instead of read
+    Expect(!CQuadTreeView(streamedMemory.data(), sizeof(SQuadTreeHeader)).IsValid(), "truncated snapshot");
+    std::string corrupted = streamed.str();
+    corrupted[0] ^= 1;
+    std::vector<uint64_t> corruptedMemory = Aligned(corrupted);
+    Expect(!CQuadTreeView(corruptedMemory.data(), corrupted.size()).IsValid(), "snapshot with a wrong magic");
+}
+
+template<class T>
+static void CheckMatrix(const char* Name) {
+    Math::Matrix<T> matrix(7, 5);
+    for (int i = 0; i < matrix.Rows(); ++i) {
+        for (int j = 0; j < matrix.Cols(); ++j) matrix[i][j] = T(i * 10 + j) / T(4);
+    }
+
+    std::stringstream out;
+    bool ok = WriteMatrix(matrix, out);
+    std::vector<uint64_t> memory = Aligned(out.str());
+    CMatrixView<T> view(memory.data(), out.str().size());
+    ok = ok && view.IsValid() && view.Rows() == matrix.Rows() && view.Cols() == matrix.Cols();
+    for (int i = 0; ok && i < matrix.Rows(); ++i) {
+        for (int j = 0; j < matrix.Cols(); ++j) ok = ok && view[i][j] == matrix[i][j];
+    }
+    if (!ok) std::printf("  %s matrix\n", Name);
+    Expect(ok, "matrix snapshot round trip");
+}
+
+int main() {
+    CheckQuadTree();
+
+    CheckMatrix<int>("int");
+    CheckMatrix<float>("float");
+    CheckMatrix<double>("double");
+    // a view of another scalar type refuses the data
+    Math::Matrix<float> matrix(2, 2);
+    std::stringstream out;
+    WriteMatrix(matrix, out);
+    std::vector<uint64_t> memory = Aligned(out.str());
+    Expect(!CMatrixView<double>(memory.data(), out.str().size()).IsValid(), "matrix view of the wrong scalar type");
+
+    std::printf("%s\n", Failures == 0 ? "PASS" : "FAIL");
+    return Failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,125 @@
+/* Sparse matrix test:
+ * CSR and CSC kernels against dense references
+ * */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../Sparse.h"
+
+using namespace Math;
+
+static int Failures = 0;
+
+static void Expect(bool Condition, const char* What) {
+    if (!Condition) {
+        std::printf("FAIL %s\n", What);
+        ++Failures;
+    }
+}
+
+static bool SameDense(const Matrix<double>& A, const Matrix<double>& B) {
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols()) return false;
+    for (int i = 0; i < A.Rows(); ++i) {
+        for (int j = 0; j < A.Cols(); ++j) {
+            if (std::fabs(A[i][j] - B[i][j]) > 1e-9) return false;
+        }
+    }
+    return true;
+}
+
+static CooMatrix<double> RandomCoo(int Rows, int Cols, int Count) {
+    CooMatrix<double> coo(Rows, Cols);
+    for (int k = 0; k < Count; ++k) {
+        coo.Add(std::rand() % Rows, std::rand() % Cols, double(std::rand() % 19 - 9));
+    }
+    return coo;
+}
+
+int main() {
+    // big enough for several blocks per kernel
+    const int Rows = 3000;
+    const int Cols = 2000;
+    std::srand(5);
+
+    CooMatrix<double> cooA = RandomCoo(Rows, Cols, 40000);
+    CooMatrix<double> cooB = RandomCoo(Rows, Cols, 40000);
+    CsrMatrix<double> csrA(cooA), csrB(cooB);
+    CscMatrix<double> cscA(cooA), cscB(cooB);
+    Matrix<double> denseA = csrA.ToDense();
+    Matrix<double> denseB = csrB.ToDense();
+
+    Expect(SameDense(cscA.ToDense(), denseA), "CSC and CSR assembly agree");
+    Expect(SameDense(csrA.ToCsc().ToDense(), denseA), "CSR to CSC");
+    Expect(SameDense(cscA.ToCsr().ToDense(), denseA), "CSC to CSR");
+
+    // transpose
+    Matrix<double> denseT(Cols, Rows);
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; ++j) denseT[j][i] = denseA[i][j];
+    }
+    Expect(SameDense(csrA.GetTranspose().ToDense(), denseT), "CSR transpose");
+    Expect(SameDense(cscA.GetTranspose().ToDense(), denseT), "CSC transpose");
+
+    CsrMatrix<double> transposed = csrA.GetTranspose();
+    bool sorted = true;
+    for (int i = 0; i < transposed.Rows(); ++i) {
+        for (int k = transposed.GetRowOffsets()[i] + 1; k < transposed.GetRowOffsets()[i + 1]; ++k) {
+            if (transposed.GetColIndices()[k - 1] >= transposed.GetColIndices()[k]) sorted = false;
+        }
+    }
+    Expect(sorted, "transpose keeps indices sorted");
+
+    // addition, including cancelling entries
+    Matrix<double> denseSum(Rows, Cols);
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; ++j) denseSum[i][j] = denseA[i][j] + denseB[i][j];
+    }
+    CsrMatrix<double> csrSum = csrA + csrB;
+    Expect(SameDense(csrSum.ToDense(), denseSum), "CSR addition");
+    Expect(SameDense((cscA + cscB).ToDense(), denseSum), "CSC addition");
+    bool noZeros = true;
+    for (size_t k = 0; k < csrSum.GetValues().size(); ++k) {
+        if (csrSum.GetValues()[k] == 0.0) noZeros = false;
+    }
+    Expect(noZeros, "addition drops zero sums");
+
+    // SpMV
+    std::vector<double> x(Cols);
+    for (int j = 0; j < Cols; ++j) x[j] = double(j % 7) - 3.0;
+    std::vector<double> expected(Rows, 0.0);
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; ++j) expected[i] += denseA[i][j] * x[j];
+    }
+    std::vector<double> yCsr = csrA * x;
+    std::vector<double> yCsc = cscA * x;
+    bool spmv = yCsr.size() == size_t(Rows) && yCsc.size() == size_t(Rows);
+    for (int i = 0; spmv && i < Rows; ++i) {
+        spmv = std::fabs(yCsr[i] - expected[i]) < 1e-9 && std::fabs(yCsc[i] - expected[i]) < 1e-9;
+    }
+    Expect(spmv, "SpMV");
+
+    // SpMM, with a width that isn't a multiple of the CSC column split
+    const int K = 37;
+    Matrix<double> denseX(Cols, K);
+    for (int j = 0; j < Cols; ++j) {
+        for (int c = 0; c < K; ++c) denseX[j][c] = double((j + c) % 5) - 2.0;
+    }
+    Matrix<double> product(Rows, K);
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; ++j) {
+            if (denseA[i][j] == 0.0) continue;
+            for (int c = 0; c < K; ++c) product[i][c] += denseA[i][j] * denseX[j][c];
+        }
+    }
+    Expect(SameDense(csrA * denseX, product), "CSR SpMM");
+    Expect(SameDense(cscA * denseX, product), "CSC SpMM");
+
+    // size mismatches give empty results
+    Expect((csrA * std::vector<double>(3)).empty(), "SpMV size mismatch");
+    Expect((csrA + CsrMatrix<double>(CooMatrix<double>(2, 2))).NonZeros() == 0, "addition size mismatch");
+
+    std::printf("%s\n", Failures == 0 ? "PASS" : "FAIL");
+    return Failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,126 @@
+/* Transforms:
+ * 2D affine transform
+ * Batched point and rectangle transforms
+ * */
+
+#include "Transform.h"
+#include <cmath>
+#include <limits>
+
+namespace Geometry_2D {
+    // ===== TRANSFORM 2D =====
+    SVector_2D STransform_2D::TransformPoint(const SVector_2D& Point) const {
+        return SVector_2D(M00 * Point.X + M01 * Point.Y + M02,
+                          M10 * Point.X + M11 * Point.Y + M12);
+    }
+
+    SVector_2D STransform_2D::TransformVector(const SVector_2D& Vector) const {
+        return SVector_2D(M00 * Vector.X + M01 * Vector.Y,
+                          M10 * Vector.X + M11 * Vector.Y);
+    }
+
+    float STransform_2D::Determinant() const {
+        return M00 * M11 - M01 * M10;
+    }
+
+    STransform_2D STransform_2D::GetInverse() const {
+        float det = Determinant();
+        if (det == 0.0f) return STransform_2D();
+
+        float inverse = 1.0f / det;
+        float i00 = M11 * inverse;
+        float i01 = -M01 * inverse;
+        float i10 = -M10 * inverse;
+        float i11 = M00 * inverse;
+
+        return STransform_2D(i00, i01, -(i00 * M02 + i01 * M12),
+                             i10, i11, -(i10 * M02 + i11 * M12));
+    }
+
+    STransform_2D CreateTranslation(const SVector_2D& Offset) {
+        return STransform_2D(1.0f, 0.0f, Offset.X,
+                             0.0f, 1.0f, Offset.Y);
+    }
+
+    STransform_2D CreateRotation(float Rad) {
+        float c = std::cos(Rad);
+        float s = std::sin(Rad);
+        return STransform_2D(c, -s, 0.0f,
+                             s, c, 0.0f);
+    }
+
+    STransform_2D CreateScale(float ScaleX, float ScaleY) {
+        return STransform_2D(ScaleX, 0.0f, 0.0f,
+                             0.0f, ScaleY, 0.0f);
+    }
+
+    STransform_2D operator*(const STransform_2D& A, const STransform_2D& B) {
+        return STransform_2D(A.M00 * B.M00 + A.M01 * B.M10,
+                             A.M00 * B.M01 + A.M01 * B.M11,
+                             A.M00 * B.M02 + A.M01 * B.M12 + A.M02,
+                             A.M10 * B.M00 + A.M11 * B.M10,
+                             A.M10 * B.M01 + A.M11 * B.M11,
+                             A.M10 * B.M02 + A.M11 * B.M12 + A.M12);
+    }
+
+    SVector_2D operator*(const STransform_2D& Transform, const SVector_2D& Point) {
+        return Transform.TransformPoint(Point);
+    }
+    // ===== TRANSFORM 2D =====
+
+
+
+    // ===== BATCHED =====
+    void TransformPoints(const STransform_2D& Transform,
+                         const SVector_2D* In, SVector_2D* Out, size_t Count) {
+        const float m00 = Transform.M00, m01 = Transform.M01, m02 = Transform.M02;
+        const float m10 = Transform.M10, m11 = Transform.M11, m12 = Transform.M12;
+
+        #pragma omp simd
+        for (size_t i = 0; i < Count; ++i) {
+            float x = In[i].X;
+            float y = In[i].Y;
+            Out[i].X = m00 * x + m01 * y + m02;
+            Out[i].Y = m10 * x + m11 * y + m12;
+        }
+    }
+
+    CRectangle TransformPointsWithBounds(const STransform_2D& Transform,
+                                         const SVector_2D* In, SVector_2D* Out, size_t Count) {
+        const float m00 = Transform.M00, m01 = Transform.M01, m02 = Transform.M02;
+        const float m10 = Transform.M10, m11 = Transform.M11, m12 = Transform.M12;
+
+        if (Count == 0) return CRectangle();
+
+        float minX = std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxX = std::numeric_limits<float>::lowest();
+        float maxY = std::numeric_limits<float>::lowest();
+
+        #pragma omp simd reduction(min:minX, minY) reduction(max:maxX, maxY)
+        for (size_t i = 0; i < Count; ++i) {
+            float x = In[i].X;
+            float y = In[i].Y;
+            float tx = m00 * x + m01 * y + m02;
+            float ty = m10 * x + m11 * y + m12;
+            Out[i].X = tx;
+            Out[i].Y = ty;
+
+            minX = tx < minX ? tx : minX;
+            minY = ty < minY ? ty : minY;
+            maxX = tx > maxX ? tx : maxX;
+            maxY = ty > maxY ? ty : maxY;
+        }
+
+        return CRectangle(SVector_2D(minX, minY), SVector_2D(maxX, maxY));
+    }
+
+    void TransformRectangles(const STransform_2D& Transform,
+                             const CRectangle* In, CRectangle* Out, size_t Count) {
+        #pragma omp simd
+        for (size_t i = 0; i < Count; ++i) {
+            TransformBounds(Transform, In[i], Out[i]);
+        }
+    }
+    // ===== BATCHED =====
+}
@@ -0,0 +1,89 @@
+/* Transforms:
+ * 2D affine transform
+ * Batched point and rectangle transforms
+ * */
+
+#ifndef MATH_TRANSFORM_H
+#define MATH_TRANSFORM_H
+
+#include <cmath>
+#include <cstddef>
+#include "MATH.h"
+
+namespace Geometry_2D {
+    // ===== TRANSFORM 2D =====
+    // 3x3 homogeneous matrix, the last row is always (0, 0, 1)
+    // | M00 M01 M02 |
+    // | M10 M11 M12 |
+    // |  0   0   1  |
+    struct STransform_2D {
+        float M00, M01, M02;
+        float M10, M11, M12;
+
+        // identity
+        inline STransform_2D() : M00(1.0f), M01(0.0f), M02(0.0f),
+                                 M10(0.0f), M11(1.0f), M12(0.0f) {}
+        inline STransform_2D(float m00, float m01, float m02,
+                             float m10, float m11, float m12) : M00(m00), M01(m01), M02(m02),
+                                                                M10(m10), M11(m11), M12(m12) {}
+
+        // applies translation
+        SVector_2D TransformPoint(const SVector_2D& Point) const;
+        // ignores translation
+        SVector_2D TransformVector(const SVector_2D& Vector) const;
+
+        float Determinant() const;
+        // returns the identity for a singular transform
+        STransform_2D GetInverse() const;
+    };
+
+    STransform_2D CreateTranslation(const SVector_2D& Offset);
+    // Rad is counter clockwise in a Y-up frame
+    STransform_2D CreateRotation(float Rad);
+    STransform_2D CreateScale(float ScaleX, float ScaleY);
+
+    // Composition: (A * B) applies B first, then A
+    STransform_2D operator*(const STransform_2D& A, const STransform_2D& B);
+
+    SVector_2D operator*(const STransform_2D& Transform, const SVector_2D& Point);
+    // ===== TRANSFORM 2D =====
+
+
+
+    // ===== BATCHED =====
+    // Out may alias In. The loops have no dependencies between elements and
+    // are marked for vectorization.
+    void TransformPoints(const STransform_2D& Transform,
+                         const SVector_2D* In, SVector_2D* Out, size_t Count);
+
+    // Transforms the points and returns their bounding box in the same pass
+    CRectangle TransformPointsWithBounds(const STransform_2D& Transform,
+                                         const SVector_2D* In, SVector_2D* Out, size_t Count);
+
+    // Out gets the axis aligned bounds of the transformed rectangle, computed
+    // from its center and half extents instead of 4 corners. Only the corners
+    // of Out are written.
+    inline void TransformBounds(const STransform_2D& Transform, const CRectangle& In, CRectangle& Out) {
+        float centerX = (In.TopLeft.X + In.BottomRight.X) * 0.5f;
+        float centerY = (In.TopLeft.Y + In.BottomRight.Y) * 0.5f;
+        float halfX = (In.BottomRight.X - In.TopLeft.X) * 0.5f;
+        float halfY = (In.BottomRight.Y - In.TopLeft.Y) * 0.5f;
+
+        // the extents of a transformed box are |M| * half extents
+        float newCenterX = Transform.M00 * centerX + Transform.M01 * centerY + Transform.M02;
+        float newCenterY = Transform.M10 * centerX + Transform.M11 * centerY + Transform.M12;
+        float newHalfX = std::fabs(Transform.M00) * halfX + std::fabs(Transform.M01) * halfY;
+        float newHalfY = std::fabs(Transform.M10) * halfX + std::fabs(Transform.M11) * halfY;
+
+        Out.TopLeft.X = newCenterX - newHalfX;
+        Out.TopLeft.Y = newCenterY - newHalfY;
+        Out.BottomRight.X = newCenterX + newHalfX;
+        Out.BottomRight.Y = newCenterY + newHalfY;
+    }
+
+    void TransformRectangles(const STransform_2D& Transform,
+                             const CRectangle* In, CRectangle* Out, size_t Count);
+    // ===== BATCHED =====
+}
+
+#endif //MATH_TRANSFORM_H
@@ -0,0 +1,40 @@
+/* Trigonometry tables:
+ * Sin, cos and atan2 from tables generated at compile time
+ * Batched sincos
+ * */
+
+#include "Trig.h"
+
+namespace Math {
+    // ===== TABLES =====
+    // constexpr, so a too expensive generation fails the build instead of
+    // silently moving to startup
+    extern constexpr SSinTable<SinTableResolution> SinTable = SSinTable<SinTableResolution>();
+    extern constexpr SAtanTable<AtanTableResolution> AtanTable = SAtanTable<AtanTableResolution>();
+    // ===== TABLES =====
+
+
+
+    // ===== BATCHED =====
+    void SinCos(const float* Angles, float* Sines, float* Cosines, size_t Count) {
+        const float* values = SinTable.Values;
+        const float stepsPerRadian = SSinTable<SinTableResolution>::StepsPerRadian();
+        const size_t mask = SinTableResolution - 1;
+        const size_t quarter = SinTableResolution / 4;
+
+        #pragma omp simd
+        for (size_t i = 0; i < Count; ++i) {
+            float steps = Angles[i] * stepsPerRadian;
+            float floored = float(int64_t(steps));
+            if (floored > steps) floored -= 1.0f;
+            float fraction = steps - floored;
+            size_t index = size_t(int64_t(floored));
+
+            size_t sinIndex = index & mask;
+            size_t cosIndex = (index + quarter) & mask;
+            Sines[i] = values[sinIndex] + (values[sinIndex + 1] - values[sinIndex]) * fraction;
+            Cosines[i] = values[cosIndex] + (values[cosIndex + 1] - values[cosIndex]) * fraction;
+        }
+    }
+    // ===== BATCHED =====
+}
@@ -0,0 +1,164 @@
+/* Trigonometry tables:
+ * Sin, cos and atan2 from tables generated at compile time
+ * Batched sincos
+ * */
+
+#ifndef MATH_TRIG_H
+#define MATH_TRIG_H
+
+#include <cstddef>
+#include <cstdint>
+#include "MATH.h"
+
+namespace Math {
+    // ===== CONSTEXPR SERIES =====
+    // Double precision series, only used to fill the tables at compile time
+    constexpr double TwoPI_Exact = 6.283185307179586476925;
+
+    // Taylor series up to x^31 after reducing x to [-pi, pi], error < 1e-15
+    constexpr double ConstexprSin(double x) {
+        while (x > TwoPI_Exact / 2) x -= TwoPI_Exact;
+        while (x < -TwoPI_Exact / 2) x += TwoPI_Exact;
+
+        double term = x;
+        double sum = x;
+        for (int n = 2; n <= 30; n += 2) {
+            term *= -x * x / (n * (n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // x in [0, 1], error < 1e-17
+    constexpr double ConstexprAtan(double x) {
+        // atan(x) = pi/4 + atan((x - 1) / (x + 1)) keeps the series argument under tan(pi/8)
+        bool shifted = x > 0.41421356237309504880;
+        double t = shifted ? (x - 1) / (x + 1) : x;
+
+        double power = t;
+        double sum = 0;
+        for (int n = 1; n <= 41; n += 2) {
+            sum += (n % 4 == 1 ? power : -power) / n;
+            power *= t * t;
+        }
+        return shifted ? sum + TwoPI_Exact / 8 : sum;
+    }
+    // ===== CONSTEXPR SERIES =====
+
+
+
+    // ===== TABLES =====
+    // Resolution is the number of entries, it has to be a power of two.
+    // Lookups interpolate linearly between entries, the *Nearest variants
+    // take the closest entry.
+    //
+    // Worst error against libm, angles in [-PI, PI]:
+    //   SSinTable<4096>    Sin/Cos 4.0e-7, nearest 7.7e-4
+    //   SSinTable<1024>    Sin/Cos 4.8e-6, nearest 3.1e-3
+    //   SAtanTable<1024>   Atan2   3.5e-7
+    // The angle is scaled to table steps in float, so the error grows with
+    // |Rad|: 7e-6 within +-100 and 8e-4 within +-1e4 for SSinTable<4096>.
+    // Keep angles wrapped when accuracy matters.
+
+    // sin over one full turn, cos reads it a quarter turn later
+    template<size_t Resolution>
+    struct SSinTable {
+        static_assert(Resolution >= 4 && (Resolution & (Resolution - 1)) == 0,
+                      "Resolution has to be a power of two");
+
+        // one extra entry, so interpolation never wraps
+        float Values[Resolution + 1];
+
+        constexpr SSinTable() : Values() {
+            for (size_t i = 0; i <= Resolution; ++i) {
+                Values[i] = float(ConstexprSin(TwoPI_Exact * double(i) / double(Resolution)));
+            }
+        }
+
+        inline float Sin(float Rad) const { return Lookup(Rad * StepsPerRadian(), 0); }
+        inline float Cos(float Rad) const { return Lookup(Rad * StepsPerRadian(), Resolution / 4); }
+
+        inline float SinNearest(float Rad) const { return LookupNearest(Rad * StepsPerRadian(), 0); }
+        inline float CosNearest(float Rad) const { return LookupNearest(Rad * StepsPerRadian(), Resolution / 4); }
+
+        static constexpr float StepsPerRadian() { return float(double(Resolution) / TwoPI_Exact); }
+
+        // Steps is the angle in table entries
+        inline float Lookup(float Steps, size_t Offset) const {
+            float floored = float(int64_t(Steps));
+            if (floored > Steps) floored -= 1.0f;
+            float fraction = Steps - floored;
+            size_t index = (size_t(int64_t(floored)) + Offset) & (Resolution - 1);
+            return Values[index] + (Values[index + 1] - Values[index]) * fraction;
+        }
+
+        inline float LookupNearest(float Steps, size_t Offset) const {
+            float rounded = float(int64_t(Steps + (Steps < 0.0f ? -0.5f : 0.5f)));
+            size_t index = (size_t(int64_t(rounded)) + Offset) & (Resolution - 1);
+            return Values[index];
+        }
+    };
+
+    // atan over [0, 1], the other octants come from symmetry
+    template<size_t Resolution>
+    struct SAtanTable {
+        static_assert(Resolution >= 4 && (Resolution & (Resolution - 1)) == 0,
+                      "Resolution has to be a power of two");
+
+        float Values[Resolution + 1];
+
+        constexpr SAtanTable() : Values() {
+            for (size_t i = 0; i <= Resolution; ++i) {
+                Values[i] = float(ConstexprAtan(double(i) / double(Resolution)));
+            }
+        }
+
+        // x in [0, 1]
+        inline float Atan(float x) const {
+            float steps = x * float(Resolution);
+            size_t index = size_t(steps);
+            if (index >= Resolution) return Values[Resolution];
+            float fraction = steps - float(index);
+            return Values[index] + (Values[index + 1] - Values[index]) * fraction;
+        }
+
+        // angle of (X, Y) in [-PI, PI], 0 for (0, 0)
+        inline float Atan2(float Y, float X) const {
+            const float pi = float(TwoPI_Exact / 2);
+            float absX = X < 0.0f ? -X : X;
+            float absY = Y < 0.0f ? -Y : Y;
+            if (absX == 0.0f && absY == 0.0f) return 0.0f;
+
+            bool swapped = absY > absX;
+            float angle = swapped ? Atan(absX / absY) : Atan(absY / absX);
+
+            if (swapped) angle = pi / 2 - angle;
+            if (X < 0.0f) angle = pi - angle;
+            if (Y < 0.0f) angle = -angle;
+            return angle;
+        }
+    };
+
+    const size_t SinTableResolution = 4096;
+    const size_t AtanTableResolution = 1024;
+
+    // Shared tables, generated by the compiler into the library's read only data
+    extern const SSinTable<SinTableResolution> SinTable;
+    extern const SAtanTable<AtanTableResolution> AtanTable;
+
+    inline float FastSin(float Rad) { return SinTable.Sin(Rad); }
+    inline float FastCos(float Rad) { return SinTable.Cos(Rad); }
+    inline float FastAtan2(float Y, float X) { return AtanTable.Atan2(Y, X); }
+    // ===== TABLES =====
+
+
+
+    // ===== BATCHED =====
+    // Sines[i] and Cosines[i] of Angles[i] from SinTable. The loop has no
+    // dependencies between elements and is marked for vectorization (the
+    // table reads become gathers).
+    void SinCos(const float* Angles, float* Sines, float* Cosines, size_t Count);
+    // ===== BATCHED =====
+}
+
+#endif //MATH_TRIG_H